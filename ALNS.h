@@ -0,0 +1,568 @@
+#ifndef ALNS_H
+#define ALNS_H
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <set>
+#include <numeric>
+#include <chrono>
+#include <mutex>
+#include <cmath>
+#include "ThreadPool.h"
+
+using namespace std;
+
+struct ALNSStats {
+    long long iterations = 0;
+    long long accepted = 0;         // iterations whose result was kept
+    double initialCost = 0.0;
+    double bestCost = 0.0;
+    double ms = 0.0;
+
+    double iterationsPerSecond() const { return ms > 0 ? iterations * 1000.0 / ms : 0.0; }
+};
+
+// ==========================================
+// Adaptive Large Neighbourhood Search over the vehicles' stop lists
+// Works on local stop ids 0..K-1 of a dense K x K cost table. Id 0 is
+// the depot. Routes are depot -> stops -> depot, and route r is capped
+// by capacity[r].
+// Objective: summed effective route cost (alpha * cost + beta *
+// (1 - rel) through the table) plus unservedPenalty * (1 + priority)
+// per stop left out. Stops are never dropped when they fit somewhere.
+// With strictPriority, stops are only inserted where the route keeps
+// non-increasing priority; the input routes must already be ordered so.
+// Each iteration removes q stops with a destroy operator:
+//   random, worst (largest removal saving), related (a seed and its
+//   nearest stops)
+// and puts them back with a repair operator:
+//   greedy (random order, cheapest position), regret-3
+// Operators are picked by roulette over adaptive weights, and results
+// are accepted by simulated annealing on elapsed budget.
+// Costs are updated incrementally: removal and insertion deltas are
+// O(1), and the removal saving of every served stop is kept in an
+// ordered set that edits update only around the positions they touch.
+// Insertion is only tried next to a stop's nearest neighbours, or in
+// an empty route, with a full scan when that finds nothing.
+// Rejected iterations roll back only the routes they touched.
+// threads independent searches share one best solution, and a search
+// that falls behind it restarts from it.
+// ==========================================
+struct ALNS {
+    double timeBudgetMs = 1000.0;
+    long long maxIterations = 0;        // per thread; 0 = until the time budget
+    unsigned threads = 1;
+    unsigned seed = 1;
+    int neighbourCount = 30;
+    bool strictPriority = false;
+    double unservedPenalty = 0.0;       // 0 = twice the longest reachable depot round trip
+    ALNSStats stats;
+
+    // table: K x K row-major; demand / priority per local id; routes:
+    // one stop list per vehicle, improved in place
+    void improve(const vector<double>& table, int K, const vector<int>& demand,
+                 const vector<int>& priority, const vector<int>& capacity,
+                 vector<vector<int>>& routes) {
+        auto t0 = chrono::steady_clock::now();
+        Shared shared;
+        shared.table = &table;
+        shared.K = K;
+        shared.demand = &demand;
+        shared.priority = &priority;
+        shared.capacity = &capacity;
+        shared.start = t0;
+        shared.config = this;
+
+        shared.penalty = unservedPenalty;
+        if (shared.penalty <= 0.0) {
+            for (int s = 1; s < K; ++s)
+                if (table[s] < 1e12 && table[size_t(s) * K] < 1e12)     // skip unreachable stops
+                    shared.penalty = max(shared.penalty, 2.0 * (table[s] + table[size_t(s) * K]));
+            shared.penalty = max(shared.penalty, 1.0);
+        }
+
+        // Nearest stops per stop
+        shared.near.assign(K, {});
+        vector<int> all;
+        int nc = min(neighbourCount, K - 2);
+        for (int s = 1; s < K && nc > 0; ++s) {
+            all.resize(K - 1);
+            iota(all.begin(), all.end(), 1);
+            all.erase(all.begin() + (s - 1));
+            partial_sort(all.begin(), all.begin() + nc, all.end(), [&](int a, int b) {
+                return table[size_t(s) * K + a] < table[size_t(s) * K + b];
+            });
+            shared.near[s].assign(all.begin(), all.begin() + nc);
+        }
+
+        Search initial(shared, seed);
+        initial.assign(routes);
+        shared.bestCost = initial.total;
+        shared.best = routes;
+        stats = ALNSStats();
+        stats.initialCost = initial.total;
+
+        ThreadPool pool(max(1u, threads));
+        vector<ALNSStats> perThread(pool.size());
+        pool.run([&](unsigned w) {
+            Search search(shared, seed + 7919 * w);
+            search.assign(routes);
+            search.run(perThread[w]);
+        });
+
+        for (const ALNSStats& st : perThread) {
+            stats.iterations += st.iterations;
+            stats.accepted += st.accepted;
+        }
+        routes = shared.best;
+        stats.bestCost = shared.bestCost;
+        stats.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    }
+
+private:
+    struct Shared {
+        const vector<double>* table;
+        int K;
+        const vector<int>* demand;
+        const vector<int>* priority;
+        const vector<int>* capacity;
+        double penalty;
+        vector<vector<int>> near;
+        chrono::steady_clock::time_point start;
+        const ALNS* config;
+
+        mutex lock;                     // guards best / bestCost
+        vector<vector<int>> best;
+        double bestCost;
+    };
+
+    enum { Random, Worst, Related, DestroyOps };
+    enum { Greedy, Regret, RepairOps };
+
+    struct Search {
+        Shared& sh;
+        mt19937 rng;
+        int K;
+        const double* d;
+        const vector<int>& demand;
+        const vector<int>& capacity;
+
+        vector<vector<int>> routes;
+        vector<int> load;
+        vector<double> cost;
+        vector<int> routeOf, posOf;         // stop -> route / index, -1 if unserved
+        vector<int> unserved;
+        double total = 0.0;
+
+        // Rollback log of the current iteration
+        vector<int> touchedRoutes;
+        vector<char> touched;
+        vector<vector<int>> savedRoutes;
+        vector<int> savedLoad;
+        vector<double> savedCost;
+        vector<int> savedUnserved;
+        double savedTotal = 0.0;
+
+        // Removal saving per served stop, most negative delta first
+        set<pair<double, int>> gains;
+        vector<double> gainOf;
+        vector<char> hasGain;
+
+        double destroyWeight[DestroyOps], repairWeight[RepairOps];
+        double destroyScore[DestroyOps], repairScore[RepairOps];
+        int destroyUses[DestroyOps], repairUses[RepairOps];
+        long long accepted = 0;
+
+        Search(Shared& s, unsigned seed)
+            : sh(s), rng(seed), K(s.K), d(s.table->data()), demand(*s.demand), capacity(*s.capacity) {
+            fill(begin(destroyWeight), end(destroyWeight), 1.0);
+            fill(begin(repairWeight), end(repairWeight), 1.0);
+            resetScores();
+        }
+
+        double dist(int a, int b) const { return d[size_t(a) * K + b]; }
+        double penalty(int s) const { return sh.penalty * (1.0 + (*sh.priority)[s]); }
+
+        void assign(const vector<vector<int>>& plan) {
+            routes = plan;
+            int R = routes.size();
+            load.assign(R, 0);
+            cost.assign(R, 0.0);
+            routeOf.assign(K, -1);
+            posOf.assign(K, -1);
+            touched.assign(R, 0);
+            savedRoutes.assign(R, {});
+            savedLoad.assign(R, 0);
+            savedCost.assign(R, 0.0);
+            total = 0.0;
+            for (int r = 0; r < R; ++r) {
+                int prev = 0;
+                for (int i = 0; i < (int)routes[r].size(); ++i) {
+                    int s = routes[r][i];
+                    routeOf[s] = r;
+                    posOf[s] = i;
+                    load[r] += demand[s];
+                    cost[r] += dist(prev, s);
+                    prev = s;
+                }
+                cost[r] += dist(prev, 0);
+                total += cost[r];
+            }
+            unserved.clear();
+            for (int s = 1; s < K; ++s)
+                if (routeOf[s] == -1) { unserved.push_back(s); total += penalty(s); }
+            gains.clear();
+            gainOf.assign(K, 0.0);
+            hasGain.assign(K, 0);
+            for (int s = 1; s < K; ++s) refreshGain(s);
+        }
+
+        void run(ALNSStats& out) {
+            const ALNS& cfg = *sh.config;
+            double current = total, best = total;
+            double t0 = max(1e-9, 0.005 * total / log(2.0));    // 0.5% worse: accepted half the time
+            double t1 = t0 / 1000.0;
+            double temperature = t0;
+            uniform_real_distribution<double> unit(0.0, 1.0);
+            long long it = 0;
+
+            for (;; ++it) {
+                if (cfg.maxIterations > 0 && it >= cfg.maxIterations) break;
+                if ((it & 63) == 0) {
+                    double elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - sh.start).count();
+                    double frac = cfg.maxIterations > 0 ? double(it) / cfg.maxIterations : elapsed / cfg.timeBudgetMs;
+                    if (cfg.maxIterations == 0 && elapsed >= cfg.timeBudgetMs) break;
+                    temperature = t0 * pow(t1 / t0, min(1.0, frac));
+                }
+                if (it > 0 && it % 100 == 0) updateWeights();
+                if (it > 0 && it % 1000 == 0) adoptShared(current, best);
+
+                int servedCount = K - 1 - unserved.size();
+                int qMax = min(40, max(1, servedCount / 5));
+                int q = uniform_int_distribution<int>(min(4, qMax), qMax)(rng);
+                int dop = roulette(destroyWeight, DestroyOps);
+                int rop = roulette(repairWeight, RepairOps);
+
+                beginIteration();
+                vector<int> pending;
+                destroy(dop, q, pending);
+                pending.insert(pending.end(), unserved.begin(), unserved.end());
+                unserved.clear();
+                repair(rop, pending);
+
+                double score = 0.0;
+                if (total < current - 1e-9 || unit(rng) < exp((current - total) / temperature)) {
+                    score = total < best - 1e-9 ? 33.0 : total < current - 1e-9 ? 9.0 : 13.0;
+                    current = total;
+                    ++accepted;
+                    if (total < best - 1e-9) {
+                        best = total;
+                        publish();
+                    }
+                } else {
+                    rollback();
+                }
+                destroyScore[dop] += score;
+                repairScore[rop] += score;
+                ++destroyUses[dop];
+                ++repairUses[rop];
+            }
+            out.iterations = it;
+            out.accepted = accepted;
+        }
+
+        int roulette(const double* weight, int n) {
+            double sum = 0.0;
+            for (int i = 0; i < n; ++i) sum += weight[i];
+            double x = uniform_real_distribution<double>(0.0, sum)(rng);
+            for (int i = 0; i < n; ++i) {
+                if (x < weight[i]) return i;
+                x -= weight[i];
+            }
+            return n - 1;
+        }
+
+        void resetScores() {
+            fill(begin(destroyScore), end(destroyScore), 0.0);
+            fill(begin(repairScore), end(repairScore), 0.0);
+            fill(begin(destroyUses), end(destroyUses), 0);
+            fill(begin(repairUses), end(repairUses), 0);
+        }
+
+        void updateWeights() {
+            const double reaction = 0.1;
+            for (int i = 0; i < DestroyOps; ++i)
+                if (destroyUses[i]) destroyWeight[i] = max(0.05, (1 - reaction) * destroyWeight[i] + reaction * destroyScore[i] / destroyUses[i]);
+            for (int i = 0; i < RepairOps; ++i)
+                if (repairUses[i]) repairWeight[i] = max(0.05, (1 - reaction) * repairWeight[i] + reaction * repairScore[i] / repairUses[i]);
+            resetScores();
+        }
+
+        void publish() {
+            lock_guard<mutex> guard(sh.lock);
+            if (total < sh.bestCost - 1e-9) {
+                sh.bestCost = total;
+                sh.best = routes;
+            }
+        }
+
+        // Restart from the shared best when another search is ahead
+        void adoptShared(double& current, double& best) {
+            lock_guard<mutex> guard(sh.lock);
+            if (sh.bestCost >= best - 1e-9) return;
+            assign(sh.best);
+            current = best = total;
+        }
+
+        // ---- incremental edits with rollback ----
+
+        void beginIteration() {
+            for (int r : touchedRoutes) touched[r] = 0;
+            touchedRoutes.clear();
+            savedUnserved = unserved;
+            savedTotal = total;
+        }
+
+        void touch(int r) {
+            if (touched[r]) return;
+            touched[r] = 1;
+            touchedRoutes.push_back(r);
+            savedRoutes[r] = routes[r];
+            savedLoad[r] = load[r];
+            savedCost[r] = cost[r];
+        }
+
+        void rollback() {
+            for (int r : touchedRoutes) {
+                for (int s : routes[r]) routeOf[s] = -1;
+                routes[r].swap(savedRoutes[r]);
+                load[r] = savedLoad[r];
+                cost[r] = savedCost[r];
+            }
+            for (int r : touchedRoutes) reindex(r, 0);
+            unserved = savedUnserved;
+            for (int s : unserved) routeOf[s] = -1;
+            total = savedTotal;
+            // Stops of the touched routes, before and after, and the unserved
+            for (int r : touchedRoutes) {
+                for (int s : routes[r]) refreshGain(s);
+                for (int s : savedRoutes[r]) refreshGain(s);
+            }
+            for (int s : unserved) refreshGain(s);
+        }
+
+        void reindex(int r, int from) {
+            for (int i = from; i < (int)routes[r].size(); ++i) {
+                routeOf[routes[r][i]] = r;
+                posOf[routes[r][i]] = i;
+            }
+        }
+
+        // Re-file s's removal saving after an edit next to it
+        void refreshGain(int s) {
+            bool served = routeOf[s] != -1;
+            double g = served ? removalDelta(s) : 0.0;
+            if (hasGain[s]) {
+                if (served && g == gainOf[s]) return;
+                gains.erase({ gainOf[s], s });
+            }
+            hasGain[s] = served;
+            if (!served) return;
+            gainOf[s] = g;
+            gains.insert({ g, s });
+        }
+
+        // Route positions [i - 1, last] after an edit at i
+        void refreshAround(int r, int i, int last) {
+            const vector<int>& route = routes[r];
+            for (int j = max(0, i - 1); j <= last && j < (int)route.size(); ++j) refreshGain(route[j]);
+        }
+
+        double removalDelta(int s) const {
+            const vector<int>& route = routes[routeOf[s]];
+            int i = posOf[s];
+            int prev = i > 0 ? route[i - 1] : 0;
+            int next = i + 1 < (int)route.size() ? route[i + 1] : 0;
+            return dist(prev, next) - dist(prev, s) - dist(s, next);
+        }
+
+        void remove(int s) {
+            int r = routeOf[s], i = posOf[s];
+            touch(r);
+            double delta = removalDelta(s);
+            cost[r] += delta;
+            total += delta + penalty(s);
+            load[r] -= demand[s];
+            routes[r].erase(routes[r].begin() + i);
+            routeOf[s] = -1;
+            reindex(r, i);
+            refreshGain(s);
+            refreshAround(r, i, i);
+        }
+
+        double insertDelta(int s, int r, int i) const {
+            const vector<int>& route = routes[r];
+            int prev = i > 0 ? route[i - 1] : 0;
+            int next = i < (int)route.size() ? route[i] : 0;
+            return dist(prev, s) + dist(s, next) - dist(prev, next);
+        }
+
+        void insert(int s, int r, int i, double delta) {
+            touch(r);
+            cost[r] += delta;
+            total += delta - penalty(s);
+            load[r] += demand[s];
+            routes[r].insert(routes[r].begin() + i, s);
+            reindex(r, i);
+            refreshAround(r, i, i + 1);
+        }
+
+        // Inserting s at (r, i) keeps the route's priorities non-increasing
+        bool keepsOrder(int s, int r, int i) const {
+            if (!sh.config->strictPriority) return true;
+            const vector<int>& pr = *sh.priority;
+            const vector<int>& route = routes[r];
+            if (i > 0 && pr[route[i - 1]] < pr[s]) return false;
+            if (i < (int)route.size() && pr[s] < pr[route[i]]) return false;
+            return true;
+        }
+
+        // ---- destroy ----
+
+        int randomServed() {
+            uniform_int_distribution<int> pick(1, K - 1);
+            for (int tries = 0; tries < 64; ++tries) {
+                int s = pick(rng);
+                if (routeOf[s] != -1) return s;
+            }
+            for (int s = 1; s < K; ++s)
+                if (routeOf[s] != -1) return s;
+            return -1;
+        }
+
+        void destroy(int op, int q, vector<int>& removed) {
+            if (op == Worst) {
+                // k-th largest saving, k biased to the front; walking
+                // the set costs O(k), and k is small on average
+                uniform_real_distribution<double> unit(0.0, 1.0);
+                for (int n = 0; n < q && !gains.empty(); ++n) {
+                    size_t k = size_t(pow(unit(rng), 4.0) * gains.size());
+                    auto it = gains.begin();
+                    advance(it, k);
+                    int s = it->second;
+                    remove(s);
+                    removed.push_back(s);
+                }
+                return;
+            }
+            if (op == Related) {
+                int seedStop = randomServed();
+                if (seedStop == -1) return;
+                remove(seedStop);
+                removed.push_back(seedStop);
+                uniform_real_distribution<double> unit(0.0, 1.0);
+                for (int t : sh.near[seedStop]) {
+                    if ((int)removed.size() >= q) break;
+                    if (routeOf[t] == -1 || unit(rng) > 0.8) continue;
+                    remove(t);
+                    removed.push_back(t);
+                }
+            }
+            while ((int)removed.size() < q) {
+                int s = randomServed();
+                if (s == -1) break;
+                remove(s);
+                removed.push_back(s);
+            }
+        }
+
+        // ---- repair ----
+
+        struct Slot {
+            double delta;
+            int route, pos;
+        };
+
+        // Cheapest feasible slot per route for s, best first (at most `limit` routes)
+        void slotsFor(int s, vector<Slot>& out, size_t limit) {
+            out.clear();
+            auto offer = [&](int r, int i) {
+                if (load[r] + demand[s] > capacity[r] || !keepsOrder(s, r, i)) return;
+                double delta = insertDelta(s, r, i);
+                for (Slot& slot : out) {
+                    if (slot.route != r) continue;
+                    if (delta < slot.delta) { slot.delta = delta; slot.pos = i; }
+                    return;
+                }
+                out.push_back({ delta, r, i });
+            };
+
+            for (int t : sh.near[s]) {
+                int r = routeOf[t];
+                if (r == -1) continue;
+                offer(r, posOf[t]);
+                offer(r, posOf[t] + 1);
+            }
+            // Tightest empty route that fits
+            int empty = -1;
+            for (int r = 0; r < (int)routes.size(); ++r)
+                if (routes[r].empty() && capacity[r] >= demand[s] &&
+                    (empty == -1 || capacity[r] < capacity[empty])) empty = r;
+            if (empty != -1) offer(empty, 0);
+
+            if (out.empty()) {
+                for (int r = 0; r < (int)routes.size(); ++r)
+                    for (int i = 0; i <= (int)routes[r].size() && load[r] + demand[s] <= capacity[r]; ++i)
+                        offer(r, i);
+            }
+            sort(out.begin(), out.end(), [](const Slot& a, const Slot& b) {
+                if (a.delta != b.delta) return a.delta < b.delta;
+                return a.route < b.route;
+            });
+            if (out.size() > limit) out.resize(limit);
+        }
+
+        void repair(int op, vector<int>& pending) {
+            vector<Slot> slots;
+            if (op == Greedy) {
+                shuffle(pending.begin(), pending.end(), rng);
+                for (int s : pending) {
+                    slotsFor(s, slots, 1);
+                    if (slots.empty()) unserved.push_back(s);
+                    else insert(s, slots[0].route, slots[0].pos, slots[0].delta);
+                }
+                return;
+            }
+
+            // Regret-3: insert the stop that loses most by waiting
+            while (!pending.empty()) {
+                int pick = -1;
+                double bestRegret = -1.0, bestDelta = 0.0;
+                Slot chosen{ 0.0, -1, -1 };
+                for (int idx = 0; idx < (int)pending.size(); ++idx) {
+                    int s = pending[idx];
+                    slotsFor(s, slots, 3);
+                    if (slots.empty()) continue;
+                    double regret = 0.0;
+                    for (size_t j = 1; j < 3; ++j)
+                        regret += (j < slots.size() ? slots[j].delta : penalty(s)) - slots[0].delta;
+                    if (regret > bestRegret || (regret == bestRegret && slots[0].delta < bestDelta)) {
+                        bestRegret = regret;
+                        bestDelta = slots[0].delta;
+                        pick = idx;
+                        chosen = slots[0];
+                    }
+                }
+                if (pick == -1) {
+                    unserved.insert(unserved.end(), pending.begin(), pending.end());
+                    return;
+                }
+                insert(pending[pick], chosen.route, chosen.pos, chosen.delta);
+                pending.erase(pending.begin() + pick);
+            }
+        }
+    };
+};
+
+#endif
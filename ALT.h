@@ -0,0 +1,253 @@
+#ifndef ALT_H
+#define ALT_H
+
+#include <vector>
+#include <queue>
+#include <limits>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <climits>
+#include <string>
+#include "Graph.h"
+
+using namespace std;
+
+// ==========================================
+// ALT: A*, Landmarks and Triangle inequality
+// k landmarks are picked by farthest-point selection on hop counts,
+// then exact effective-cost distances from each are computed in
+// parallel. For an undirected graph |d(L,t) - d(L,v)| <= d(v,t), so
+// the max over landmarks is an admissible, consistent A* potential.
+// Distances ignore edge availability: closing edges only lengthens
+// paths, so the bounds stay valid after setEdgeAvailability.
+// ==========================================
+struct LandmarkIndex {
+    int N = 0;
+    int k = 0;
+    double alpha = 1.0, beta = 1.0;
+    uint64_t signature = 0;
+    vector<int> landmarks;
+    vector<double> dist;            // node-major: dist[v * k + l]
+
+    bool empty() const { return k == 0; }
+
+    bool matches(const Graph& graph, int landmarkCount, double a, double b) const {
+        return k == landmarkCount && N == graph.N && alpha == a && beta == b &&
+               signature == graphSignature(graph, landmarkCount, a, b);
+    }
+
+    // Lower bound on the effective cost v -> t
+    double lowerBound(int v, int t) const {
+        const double* dv = &dist[size_t(v) * k];
+        const double* dt = &dist[size_t(t) * k];
+        const double INF = numeric_limits<double>::max();
+        double h = 0.0;
+        for (int l = 0; l < k; ++l) {
+            if (dv[l] == INF || dt[l] == INF) continue;
+            double diff = dv[l] > dt[l] ? dv[l] - dt[l] : dt[l] - dv[l];
+            if (diff > h) h = diff;
+        }
+        return h;
+    }
+
+    void build(const Graph& graph, int landmarkCount, double a, double b, unsigned threads = 0) {
+        N = graph.N;
+        alpha = a;
+        beta = b;
+        signature = graphSignature(graph, landmarkCount, a, b);
+        selectLandmarks(graph, landmarkCount);
+        k = landmarks.size();
+        dist.assign(size_t(N) * k, numeric_limits<double>::max());
+
+        if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+        atomic<int> next(0);
+        auto worker = [&]() {
+            vector<double> d;
+            for (int l = next++; l < k; l = next++) {
+                distancesFrom(graph, landmarks[l], d);
+                for (int v = 0; v < N; ++v) dist[size_t(v) * k + l] = d[v];
+            }
+        };
+        unsigned n = min<unsigned>(threads, k);
+        if (n <= 1) { worker(); return; }
+        vector<thread> pool;
+        for (unsigned t = 0; t < n; ++t) pool.emplace_back(worker);
+        for (auto& t : pool) t.join();
+    }
+
+    bool save(const string& path) const {
+        FILE* f = fopen(path.c_str(), "wb");
+        if (!f) return false;
+        fwrite("ALT1", 1, 4, f);
+        fwrite(&signature, sizeof(signature), 1, f);
+        fwrite(&N, sizeof(N), 1, f);
+        fwrite(&k, sizeof(k), 1, f);
+        fwrite(&alpha, sizeof(alpha), 1, f);
+        fwrite(&beta, sizeof(beta), 1, f);
+        fwrite(landmarks.data(), sizeof(int), k, f);
+        fwrite(dist.data(), sizeof(double), dist.size(), f);
+        return fclose(f) == 0;
+    }
+
+    // Load a saved index; fails if the file was built for another graph or weighting
+    bool load(const string& path, const Graph& graph, int landmarkCount, double a, double b) {
+        FILE* f = fopen(path.c_str(), "rb");
+        if (!f) return false;
+        LandmarkIndex in;
+        char magic[4];
+        bool ok = fread(magic, 1, 4, f) == 4 && memcmp(magic, "ALT1", 4) == 0 &&
+                  fread(&in.signature, sizeof(in.signature), 1, f) == 1 &&
+                  fread(&in.N, sizeof(in.N), 1, f) == 1 &&
+                  fread(&in.k, sizeof(in.k), 1, f) == 1 &&
+                  fread(&in.alpha, sizeof(in.alpha), 1, f) == 1 &&
+                  fread(&in.beta, sizeof(in.beta), 1, f) == 1 &&
+                  in.k > 0 && in.matches(graph, landmarkCount, a, b);
+        if (ok) {
+            in.landmarks.resize(in.k);
+            in.dist.resize(size_t(in.N) * in.k);
+            ok = fread(in.landmarks.data(), sizeof(int), in.k, f) == size_t(in.k) &&
+                 fread(in.dist.data(), sizeof(double), in.dist.size(), f) == in.dist.size();
+        }
+        fclose(f);
+        if (ok) *this = in;
+        return ok;
+    }
+
+    // FNV-1a over the structure and weights the distances depend on
+    static uint64_t graphSignature(const Graph& graph, int landmarkCount, double a, double b) {
+        uint64_t h = 1469598103934665603ULL;
+        auto mix = [&](const void* p, size_t n) {
+            const unsigned char* c = (const unsigned char*)p;
+            for (size_t i = 0; i < n; ++i) { h ^= c[i]; h *= 1099511628211ULL; }
+        };
+        mix(&graph.N, sizeof(graph.N));
+        mix(&landmarkCount, sizeof(landmarkCount));
+        mix(&a, sizeof(a));
+        mix(&b, sizeof(b));
+        for (const Edge& e : graph.edges) {
+            mix(&e.u, sizeof(e.u));
+            mix(&e.v, sizeof(e.v));
+            mix(&e.cost, sizeof(e.cost));
+            mix(&e.reliability, sizeof(e.reliability));
+        }
+        return h;
+    }
+
+private:
+    // Farthest-point selection by BFS hop distance: cheap and spreads
+    // landmarks to the periphery, where their bounds are tightest
+    void selectLandmarks(const Graph& graph, int count) {
+        landmarks.clear();
+        if (N == 0) return;
+        vector<int> minHops(N, INT_MAX), hops(N);
+        int next = 0;
+        bfs(graph, 0, hops);
+        for (int v = 0; v < N; ++v)
+            if (hops[v] != INT_MAX && hops[v] > hops[next]) next = v;
+
+        while ((int)landmarks.size() < min(count, N)) {
+            landmarks.push_back(next);
+            bfs(graph, next, hops);
+            int far = -1;
+            for (int v = 0; v < N; ++v) {
+                minHops[v] = min(minHops[v], hops[v]);
+                // unreached nodes (other components) count as infinitely far
+                if (minHops[v] > 0 && (far == -1 || minHops[v] > minHops[far])) far = v;
+            }
+            if (far == -1) break;
+            next = far;
+        }
+    }
+
+    void bfs(const Graph& graph, int s, vector<int>& hops) const {
+        fill(hops.begin(), hops.end(), INT_MAX);
+        vector<int> q;
+        q.push_back(s);
+        hops[s] = 0;
+        for (size_t i = 0; i < q.size(); ++i) {
+            int u = q[i];
+            for (int k2 = graph.csrOffset[u]; k2 < graph.csrOffset[u + 1]; ++k2) {
+                int v = graph.csrTo[k2];
+                if (hops[v] != INT_MAX) continue;
+                hops[v] = hops[u] + 1;
+                q.push_back(v);
+            }
+        }
+    }
+
+    // Plain Dijkstra on effective costs over every edge, open or closed
+    void distancesFrom(const Graph& graph, int s, vector<double>& d) const {
+        d.assign(N, numeric_limits<double>::max());
+        priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> pq;
+        d[s] = 0;
+        pq.push({ 0.0, s });
+        while (!pq.empty()) {
+            auto [du, u] = pq.top(); pq.pop();
+            if (du > d[u]) continue;
+            for (int e = graph.csrOffset[u]; e < graph.csrOffset[u + 1]; ++e) {
+                int v = graph.csrTo[e];
+                double nd = du + alpha * graph.csrCost[e] + beta * (1.0 - graph.csrRel[e]);
+                if (nd < d[v]) {
+                    d[v] = nd;
+                    pq.push({ nd, v });
+                }
+            }
+        }
+    }
+};
+
+// ==========================================
+// A* query over a LandmarkIndex (weights fixed by the index)
+// ==========================================
+struct ALTSearch {
+    const Graph& graph;
+    const LandmarkIndex& index;
+    DijkstraWorkspace ws;
+    int settled = 0;
+
+    ALTSearch(const Graph& g, const LandmarkIndex& idx) : graph(g), index(idx) {}
+
+    bool search(int start, int end) {
+        ws.reset(graph.N);
+        ws.touch(start);
+        ws.dist[start] = 0;
+        ws.pathReli[start] = 1.0;
+        ws.push({ index.lowerBound(start, end), start, 1.0 });
+
+        while (!ws.heap.empty()) {
+            SearchState top = ws.pop();
+            int u = top.u;
+            if (top.effCost > ws.dist[u] + index.lowerBound(u, end)) continue;   // stale key
+            ++ws.settled;
+            if (u == end) break;
+
+            for (int k = graph.csrOffset[u]; k < graph.csrOffset[u + 1]; ++k) {
+                if (!graph.arcAvailable[k]) continue;
+
+                int v = graph.csrTo[k];
+                double edgeRel = graph.csrRel[k];
+                double nd = ws.dist[u] + index.alpha * graph.csrCost[k] + index.beta * (1.0 - edgeRel);
+
+                ws.touch(v);
+                if (nd < ws.dist[v]) {
+                    ws.dist[v] = nd;
+                    ws.parent[v] = u;
+                    ws.pathReli[v] = top.relSum * edgeRel;
+                    ws.push({ nd + index.lowerBound(v, end), v, ws.pathReli[v] });
+                }
+            }
+        }
+
+        settled = ws.settled;
+        return ws.getDist(end) != numeric_limits<double>::max();
+    }
+
+    double cost(int end) const { return ws.getDist(end); }
+
+    void appendPath(int end, vector<int>& out) const { ws.appendPath(end, out); }
+};
+
+#endif
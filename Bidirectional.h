@@ -0,0 +1,98 @@
+#ifndef BIDIRECTIONAL_H
+#define BIDIRECTIONAL_H
+
+#include <vector>
+#include <limits>
+#include "Graph.h"
+
+using namespace std;
+
+// ==========================================
+// Bidirectional multi-objective Dijkstra
+// Forward search from start and backward search from end (the graph
+// is undirected, so both walk the same CSR arrays). Every label
+// improvement checks the opposite side and keeps the best meeting
+// point mu; the search stops once topF + topB >= mu, which is exact for
+// the non-negative weights alpha * cost + beta * (1 - rel).
+// Ties between equal-cost paths are not broken on reliability.
+// ==========================================
+struct BidirectionalDijkstra {
+    const Graph& graph;
+    DijkstraWorkspace fwd, bwd;
+    double best = numeric_limits<double>::max();
+    int meet = -1;                  // node where the two trees join
+    int settled = 0;                // nodes settled by both sides, last query
+
+    BidirectionalDijkstra(const Graph& g) : graph(g) {}
+
+    bool search(int start, int end, double alpha = 1.0, double beta = 1.0) {
+        fwd.reset(graph.N);
+        bwd.reset(graph.N);
+        init(fwd, start);
+        init(bwd, end);
+        best = numeric_limits<double>::max();
+        meet = -1;
+        if (start == end) { best = 0; meet = start; }
+
+        while (!fwd.heap.empty() && !bwd.heap.empty()) {
+            if (fwd.heap.front().effCost + bwd.heap.front().effCost >= best) break;
+
+            // Advance the side with the smaller frontier key
+            if (fwd.heap.front().effCost <= bwd.heap.front().effCost)
+                step(fwd, bwd, alpha, beta);
+            else
+                step(bwd, fwd, alpha, beta);
+        }
+
+        settled = fwd.settled + bwd.settled;
+        return meet != -1;
+    }
+
+    double cost() const { return best; }
+
+    // Append start -> end, excluding start, after a successful search
+    void appendPath(vector<int>& out) const {
+        fwd.appendPath(meet, out);
+        for (int v = bwd.parent[meet]; v != -1; v = bwd.parent[v])
+            out.push_back(v);
+    }
+
+private:
+    static void init(DijkstraWorkspace& ws, int s) {
+        ws.touch(s);
+        ws.dist[s] = 0;
+        ws.pathReli[s] = 1.0;
+        ws.push({ 0.0, s, 1.0 });
+    }
+
+    void step(DijkstraWorkspace& ws, const DijkstraWorkspace& other, double alpha, double beta) {
+        SearchState top = ws.pop();
+        int u = top.u;
+        if (top.effCost > ws.dist[u]) return;
+        ++ws.settled;
+
+        for (int k = graph.csrOffset[u]; k < graph.csrOffset[u + 1]; ++k) {
+            if (!graph.arcAvailable[k]) continue;
+
+            int v = graph.csrTo[k];
+            double edgeRel = graph.csrRel[k];
+            double nd = ws.dist[u] + alpha * graph.csrCost[k] + beta * (1.0 - edgeRel);
+
+            ws.touch(v);
+            if (nd < ws.dist[v]) {
+                ws.dist[v] = nd;
+                ws.parent[v] = u;
+                ws.pathReli[v] = top.relSum * edgeRel;
+                ws.push({ nd, v, ws.pathReli[v] });
+
+                double od = other.getDist(v);
+                if (od != numeric_limits<double>::max() && nd + od < best) {
+                    best = nd + od;
+                    meet = v;
+                }
+            }
+        }
+    }
+};
+
+#endif
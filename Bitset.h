@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Fixed-width bit array in 64-bit words. Bits past size() are kept zero
+// so word-wise comparisons need no masking.
+struct Bitset {
+    vector<uint64_t> words;
+    size_t bits = 0;
+
+    size_t size() const { return bits; }
+
+    void assign(size_t n, bool value) {
+        bits = n;
+        words.assign((n + 63) / 64, value ? ~uint64_t(0) : 0);
+        if (value && n % 64) words.back() = (uint64_t(1) << (n % 64)) - 1;
+    }
+
+    void push_back(bool value) {
+        if (bits % 64 == 0) words.push_back(0);
+        ++bits;
+        set(bits - 1, value);
+    }
+
+    bool test(size_t i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+    bool operator[](size_t i) const { return test(i); }
+
+    void set(size_t i, bool value = true) {
+        uint64_t mask = uint64_t(1) << (i & 63);
+        if (value) words[i >> 6] |= mask;
+        else words[i >> 6] &= ~mask;
+    }
+
+    size_t count() const {
+        size_t n = 0;
+        for (uint64_t w : words) n += __builtin_popcountll(w);
+        return n;
+    }
+
+    // True if some bit is set here but not in `other` (same size)
+    bool hasBitsNotIn(const Bitset& other) const {
+        for (size_t w = 0; w < words.size(); ++w)
+            if (words[w] & ~other.words[w]) return true;
+        return false;
+    }
+};
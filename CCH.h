@@ -0,0 +1,411 @@
+#ifndef CCH_H
+#define CCH_H
+
+#include <vector>
+#include <limits>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <queue>
+#include <atomic>
+#include "Graph.h"
+
+using namespace std;
+
+// Timings reported by CustomizableCH / CCHSearch
+struct CCHStats {
+    double orderMs = 0.0;           // metric-independent preprocessing
+    double customizeMs = 0.0;       // last customization
+    int customizations = 0;
+    int recomputedNodes = 0;        // nodes redone by the last customization
+    long long queries = 0;
+    double queryMs = 0.0;           // total over all queries
+    long long arcs = 0;             // arcs in the chordal supergraph
+
+    double avgQueryMs() const { return queries ? queryMs / queries : 0.0; }
+};
+
+// ==========================================
+// Customizable Contraction Hierarchies
+// Phase 1 (once per road network): a minimum-degree elimination order
+// and the chordal supergraph it induces; no weights involved.
+// Phase 2 (after every batch of closures / reliability changes):
+// customization assigns each arc min(base weight, lower triangles).
+// Nodes on the same elimination-tree level only write their own arcs
+// and only read arcs of lower levels, so each level runs in parallel.
+// Closed edges simply get an infinite base weight, and re-customizing
+// after a small batch only revisits nodes whose inputs changed.
+// ==========================================
+struct CustomizableCH {
+    int N = 0;
+    vector<int> rank;               // node -> elimination position
+    vector<int> etParent;           // elimination tree parent, -1 at roots
+
+    // Upward arcs u -> w (rank[w] > rank[u]), sorted by rank[w]
+    vector<int> upOffset;
+    vector<int> upTo;
+    // Downward view: for node u, arcs v -> u with rank[v] < rank[u]
+    vector<int> downOffset;
+    vector<int> downFrom;
+    vector<int> downArc;            // index into upTo of v -> u
+
+    vector<int> levelOffset;        // elimination-tree levels, bottom up
+    vector<int> levelNodes;
+    vector<int> edgeArc;            // graph edge id -> arc, -1 for self loops
+
+    // Metric, filled by customize()
+    vector<double> weight;          // arc -> effective cost
+    vector<int> mid;                // arc -> triangle node it went through, -1 if original
+    double alpha = 1.0, beta = 1.0;
+    unsigned customizedAvailability = 0;
+    unsigned customizedWeights = 0;
+    bool customized = false;
+
+    CCHStats stats;
+
+    bool empty() const { return N == 0; }
+
+    bool needsCustomization(const Graph& graph, double a, double b) const {
+        return !customized || alpha != a || beta != b ||
+               customizedAvailability != graph.availabilityVersion ||
+               customizedWeights != graph.weightVersion;
+    }
+
+    // Phase 1: metric-independent order and chordal supergraph
+    void buildOrder(const Graph& graph) {
+        auto t0 = chrono::steady_clock::now();
+        N = graph.N;
+        customized = false;
+
+        vector<vector<int>> nb(N);
+        for (const Edge& e : graph.edges) {
+            if (e.u == e.v) continue;
+            nb[e.u].push_back(e.v);
+            nb[e.v].push_back(e.u);
+        }
+        for (auto& list : nb) {
+            sort(list.begin(), list.end());
+            list.erase(unique(list.begin(), list.end()), list.end());
+        }
+
+        // Minimum-degree elimination with lazy degree updates
+        rank.assign(N, -1);
+        vector<vector<int>> up(N);
+        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+        for (int v = 0; v < N; ++v) pq.push({ (int)nb[v].size(), v });
+        int next = 0;
+        vector<int> merged;
+        while (!pq.empty()) {
+            auto [deg, v] = pq.top(); pq.pop();
+            if (rank[v] != -1 || deg != (int)nb[v].size()) continue;
+
+            // Remaining graph is a clique: every order is equivalent
+            if (deg == N - next - 1) break;
+
+            rank[v] = next++;
+            up[v] = nb[v];
+            for (int u : up[v]) {
+                // nb[u] := nb[u] + nb[v] - {u, v}
+                merged.clear();
+                set_union(nb[u].begin(), nb[u].end(), nb[v].begin(), nb[v].end(), back_inserter(merged));
+                merged.erase(remove_if(merged.begin(), merged.end(),
+                                       [&](int x) { return x == u || x == v; }), merged.end());
+                nb[u].swap(merged);
+                pq.push({ (int)nb[u].size(), u });
+            }
+            vector<int>().swap(nb[v]);
+        }
+        vector<int> clique;
+        for (int v = 0; v < N; ++v)
+            if (rank[v] == -1) { rank[v] = next++; clique.push_back(v); }
+        for (int v : clique)
+            for (int u : nb[v])
+                if (rank[u] > rank[v]) up[v].push_back(u);
+
+        // Upward CSR sorted by rank of the head
+        upOffset.assign(N + 1, 0);
+        for (int v = 0; v < N; ++v) upOffset[v + 1] = upOffset[v] + up[v].size();
+        upTo.resize(upOffset[N]);
+        etParent.assign(N, -1);
+        for (int v = 0; v < N; ++v) {
+            sort(up[v].begin(), up[v].end(), [&](int a, int b) { return rank[a] < rank[b]; });
+            copy(up[v].begin(), up[v].end(), upTo.begin() + upOffset[v]);
+            if (!up[v].empty()) etParent[v] = up[v][0];
+            vector<int>().swap(up[v]);
+        }
+
+        // Downward view, grouped by head and ordered by rank of the tail
+        vector<int> byRank(N);
+        for (int v = 0; v < N; ++v) byRank[rank[v]] = v;
+        downOffset.assign(N + 1, 0);
+        for (int k = 0; k < upOffset[N]; ++k) ++downOffset[upTo[k] + 1];
+        for (int v = 0; v < N; ++v) downOffset[v + 1] += downOffset[v];
+        downFrom.resize(upOffset[N]);
+        downArc.resize(upOffset[N]);
+        vector<int> cursor(downOffset.begin(), downOffset.end() - 1);
+        for (int v : byRank) {
+            for (int k = upOffset[v]; k < upOffset[v + 1]; ++k) {
+                int slot = cursor[upTo[k]]++;
+                downFrom[slot] = v;
+                downArc[slot] = k;
+            }
+        }
+
+        // Levels: one more than the highest lower neighbour
+        vector<int> level(N, 0);
+        int maxLevel = 0;
+        for (int v : byRank) {
+            for (int k = upOffset[v]; k < upOffset[v + 1]; ++k)
+                level[upTo[k]] = max(level[upTo[k]], level[v] + 1);
+            maxLevel = max(maxLevel, level[v]);
+        }
+        levelOffset.assign(maxLevel + 2, 0);
+        for (int v = 0; v < N; ++v) ++levelOffset[level[v] + 1];
+        for (int l = 0; l <= maxLevel; ++l) levelOffset[l + 1] += levelOffset[l];
+        levelNodes.resize(N);
+        vector<int> pos(levelOffset.begin(), levelOffset.end() - 1);
+        for (int v = 0; v < N; ++v) levelNodes[pos[level[v]]++] = v;
+
+        edgeArc.assign(graph.edges.size(), -1);
+        for (size_t e = 0; e < graph.edges.size(); ++e) {
+            int u = graph.edges[e].u, v = graph.edges[e].v;
+            if (u != v) edgeArc[e] = findArc(u, v);
+        }
+
+        weight.assign(upOffset[N], numeric_limits<double>::max());
+        mid.assign(upOffset[N], -1);
+        base.assign(upOffset[N], numeric_limits<double>::max());
+        stats.arcs = upOffset[N];
+        stats.orderMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    }
+
+    // Phase 2: weights for the current availability / reliabilities.
+    // After the first run only nodes whose inputs changed are recomputed:
+    // u is redone if one of its own base weights changed or a lower
+    // neighbour v (whose arcs u reads) changed any of its arcs.
+    void customize(const Graph& graph, double a, double b, unsigned threads = 0) {
+        auto t0 = chrono::steady_clock::now();
+        const double INF = numeric_limits<double>::max();
+        bool full = !customized || alpha != a || beta != b;
+        alpha = a;
+        beta = b;
+
+        vector<double> newBase(upOffset[N], INF);
+        for (size_t e = 0; e < graph.edges.size(); ++e) {
+            if (edgeArc[e] == -1 || !graph.edgeAvailable[e]) continue;
+            const Edge& ed = graph.edges[e];
+            double w = alpha * ed.cost + beta * (1.0 - ed.reliability);
+            if (w < newBase[edgeArc[e]]) newBase[edgeArc[e]] = w;
+        }
+        baseChanged.assign(N, full);
+        if (!full) {
+            for (int u = 0; u < N; ++u)
+                for (int k = upOffset[u]; k < upOffset[u + 1]; ++k)
+                    if (newBase[k] != base[k]) { baseChanged[u] = 1; break; }
+        }
+        base.swap(newBase);
+        changed.assign(N, 0);
+
+        if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+        int levels = levelOffset.size() - 1;
+        atomic<int> recomputed(0);
+        if (threads <= 1) {
+            vector<double> old;
+            for (int i = 0; i < N; ++i)
+                if (customizeNode(levelNodes[i], old)) ++recomputed;
+        } else {
+            LevelBarrier barrier(threads);
+            auto worker = [&](unsigned id) {
+                vector<double> old;
+                int mine = 0;
+                for (int l = 0; l < levels; ++l) {
+                    for (int i = levelOffset[l] + id; i < levelOffset[l + 1]; i += threads)
+                        if (customizeNode(levelNodes[i], old)) ++mine;
+                    barrier.wait();
+                }
+                recomputed += mine;
+            };
+            vector<thread> pool;
+            for (unsigned t = 0; t < threads; ++t) pool.emplace_back(worker, t);
+            for (auto& t : pool) t.join();
+        }
+
+        customizedAvailability = graph.availabilityVersion;
+        customizedWeights = graph.weightVersion;
+        customized = true;
+        ++stats.customizations;
+        stats.recomputedNodes = recomputed;
+        stats.customizeMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    }
+
+    // Arc between a and b (stored at the lower-ranked end), or -1
+    int findArc(int a, int b) const {
+        if (rank[a] > rank[b]) swap(a, b);
+        int lo = upOffset[a], hi = upOffset[a + 1];
+        while (lo < hi) {
+            int m = (lo + hi) / 2;
+            if (rank[upTo[m]] < rank[b]) lo = m + 1; else hi = m;
+        }
+        return lo < upOffset[a + 1] && upTo[lo] == b ? lo : -1;
+    }
+
+    // Append the original nodes of arc a - b, excluding a
+    void unpack(int a, int b, vector<int>& out) const {
+        vector<pair<int, int>> stack;
+        stack.push_back({ a, b });
+        while (!stack.empty()) {
+            auto [x, y] = stack.back(); stack.pop_back();
+            int m = mid[findArc(x, y)];
+            if (m == -1) {
+                out.push_back(y);
+            } else {
+                stack.push_back({ m, y });
+                stack.push_back({ x, m });
+            }
+        }
+    }
+
+private:
+    vector<double> base;            // arc -> weight of the original edge(s), INF if none/closed
+    vector<char> baseChanged;       // node -> one of its base weights changed this run
+    vector<char> changed;           // node -> one of its arc weights changed this run
+
+    // Pull lower triangles v - u - w into u's own upward arcs.
+    // Returns false (and leaves u alone) when none of its inputs changed.
+    bool customizeNode(int u, vector<double>& old) {
+        const double INF = numeric_limits<double>::max();
+        bool dirty = baseChanged[u];
+        for (int d = downOffset[u]; d < downOffset[u + 1] && !dirty; ++d)
+            dirty = changed[downFrom[d]];
+        if (!dirty) return false;
+
+        int uBegin = upOffset[u], uEnd = upOffset[u + 1];
+        old.assign(weight.begin() + uBegin, weight.begin() + uEnd);
+        for (int j = uBegin; j < uEnd; ++j) {
+            weight[j] = base[j];
+            mid[j] = -1;
+        }
+
+        for (int d = downOffset[u]; d < downOffset[u + 1]; ++d) {
+            int v = downFrom[d];
+            double wvu = weight[downArc[d]];
+            if (wvu == INF) continue;
+            // up(v) and up(u) are both sorted by rank: merge past u
+            int i = downArc[d] + 1, j = uBegin;
+            int vEnd = upOffset[v + 1];
+            while (i < vEnd && j < uEnd) {
+                int ri = rank[upTo[i]], rj = rank[upTo[j]];
+                if (ri < rj) { ++i; continue; }
+                if (rj < ri) { ++j; continue; }
+                if (weight[i] != INF && wvu + weight[i] < weight[j]) {
+                    weight[j] = wvu + weight[i];
+                    mid[j] = v;
+                }
+                ++i; ++j;
+            }
+        }
+
+        for (int j = uBegin; j < uEnd; ++j)
+            if (weight[j] != old[j - uBegin]) { changed[u] = 1; break; }
+        return true;
+    }
+
+    // Reusable barrier for the level-synchronous customization
+    struct LevelBarrier {
+        mutex m;
+        condition_variable cv;
+        unsigned count, waiting = 0, phase = 0;
+
+        LevelBarrier(unsigned n) : count(n) {}
+
+        void wait() {
+            unique_lock<mutex> lock(m);
+            unsigned p = phase;
+            if (++waiting == count) {
+                waiting = 0;
+                ++phase;
+                cv.notify_all();
+            } else {
+                cv.wait(lock, [&] { return phase != p; });
+            }
+        }
+    };
+};
+
+// ==========================================
+// CCH query: elimination-tree search
+// Every node reachable upward from s is an ancestor of s in the
+// elimination tree, so both sides just walk their ancestor chains in
+// rank order relaxing upward arcs (no priority queue); the best meeting
+// node is a common ancestor.
+// ==========================================
+struct CCHSearch {
+    const Graph& graph;
+    const CustomizableCH& cch;
+    DijkstraWorkspace fwd, bwd;
+    vector<int> path;               // last result, start excluded
+    int settled = 0;
+    long long queries = 0;          // this searcher's share of CCHStats::queries / queryMs
+    double queryMs = 0.0;
+
+    CCHSearch(const Graph& g, const CustomizableCH& c) : graph(g), cch(c) {}
+
+    bool search(int start, int end) {
+        auto t0 = chrono::steady_clock::now();
+        path.clear();
+        settled = 0;
+        fwd.reset(graph.N);
+        bwd.reset(graph.N);
+        sweep(fwd, start);
+        sweep(bwd, end);
+
+        const double INF = numeric_limits<double>::max();
+        double best = INF;
+        int meet = -1;
+        for (int v = start; v != -1; v = cch.etParent[v]) {
+            double df = fwd.getDist(v), db = bwd.getDist(v);
+            if (df == INF || db == INF) continue;
+            if (df + db < best) { best = df + db; meet = v; }
+        }
+
+        if (meet != -1) {
+            vector<int> chain;
+            for (int v = meet; v != -1; v = fwd.parent[v]) chain.push_back(v);
+            for (size_t i = chain.size() - 1; i > 0; --i) cch.unpack(chain[i], chain[i - 1], path);
+            for (int v = meet; bwd.parent[v] != -1; v = bwd.parent[v]) cch.unpack(v, bwd.parent[v], path);
+        }
+
+        ++queries;
+        queryMs += chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        return meet != -1;
+    }
+
+    void appendPath(vector<int>& out) const { out.insert(out.end(), path.begin(), path.end()); }
+
+private:
+    void sweep(DijkstraWorkspace& ws, int s) {
+        const double INF = numeric_limits<double>::max();
+        ws.touch(s);
+        ws.dist[s] = 0;
+        for (int v = s; v != -1; v = cch.etParent[v]) {
+            ws.touch(v);
+            ++settled;
+            double dv = ws.dist[v];
+            if (dv == INF) continue;
+            for (int k = cch.upOffset[v]; k < cch.upOffset[v + 1]; ++k) {
+                if (cch.weight[k] == INF) continue;
+                int w = cch.upTo[k];
+                double nd = dv + cch.weight[k];
+                ws.touch(w);
+                if (nd < ws.dist[w]) {
+                    ws.dist[w] = nd;
+                    ws.parent[w] = v;
+                }
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+#include <set>
+#include "vehicle.h"
+
+using namespace std;
+
+// Vehicles ordered by remaining capacity, for best-fit lookups in
+// O(log V) instead of a scan over the fleet. Ties go to the lowest
+// vehicle index, the same choice as a first-to-last scan keeping the
+// strictly smaller remainder.
+struct CapacityIndex {
+    set<pair<int, int>> slots;      // (remaining capacity, vehicle index)
+    vector<int> remaining;          // vehicle index -> remaining capacity
+
+    void init(const vector<Vehicle>& vehicles) {
+        slots.clear();
+        remaining.resize(vehicles.size());
+        for (size_t i = 0; i < vehicles.size(); ++i) {
+            remaining[i] = vehicles[i].capacity;
+            slots.insert({ remaining[i], (int)i });
+        }
+    }
+
+    // Vehicle with the least remaining capacity >= demand, -1 if none
+    int bestFit(int demand) const {
+        auto it = slots.lower_bound({ demand, -1 });
+        return it == slots.end() ? -1 : it->second;
+    }
+
+    void take(int vehicle, int demand) {
+        slots.erase({ remaining[vehicle], vehicle });
+        remaining[vehicle] -= demand;
+        slots.insert({ remaining[vehicle], vehicle });
+    }
+
+    // Stop / resume offering a vehicle to later lookups
+    void remove(int vehicle) { slots.erase({ remaining[vehicle], vehicle }); }
+    void restore(int vehicle) { slots.insert({ remaining[vehicle], vehicle }); }
+};
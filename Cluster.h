@@ -0,0 +1,212 @@
+#ifndef CLUSTER_H
+#define CLUSTER_H
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include "Graph.h"
+#include "vehicle.h"
+#include "ThreadPool.h"
+#include "StopOrdering.h"
+#include "CapacityIndex.h"
+
+using namespace std;
+
+// ==========================================
+// Cluster-first, route-second allocator
+// Capacitated k-medoids over graph distance, one cluster per vehicle:
+//   seed     - farthest-first from the depot, so the first medoids
+//              spread out
+//   assign   - one full search per medoid. Stops go to the nearest
+//              medoid with capacity left, highest priority first, then
+//              the stops that lose most by missing their best medoid.
+//              Vehicle i caps cluster i.
+//   update   - each cluster's new medoid is the member with the
+//              smallest summed distance to the other members
+// These repeat until the medoids stop moving or maxIterations is hit.
+// Each cluster is then ordered depot -> stops -> depot with
+// StopOrdering.
+// Stop-to-stop distances for the update and the ordering are not
+// searched. They are estimated from the medoid and depot trees with the
+// landmark bound max_c |d(c, a) - d(c, b)|, so an iteration costs one
+// search per moved medoid. Those searches run in parallel on a
+// ThreadPool, as does the per-cluster work.
+// Stops that fit no cluster go best-fit into leftover capacity.
+// ==========================================
+struct ClusterAllocator {
+    const Graph& graph;
+    double alpha = 1.0, beta = 1.0;
+    int maxIterations = 6;
+    unsigned threads = 0;           // 0 = every hardware thread
+    int iterations = 0;             // last call
+
+    ClusterAllocator(const Graph& g) : graph(g) {}
+
+    vector<vector<int>> allocate(const vector<Vehicle>& vehicles) {
+        const double INF = numeric_limits<double>::max();
+        vector<vector<int>> assigned(vehicles.size());
+        ThreadPool pool(threads);
+        workspaces.resize(pool.size());
+
+        distancesFrom(workspaces[0], 0, depotDist);
+
+        vector<int> stops;
+        for (const Node& n : graph.nodes)
+            if (n.id != 0 && depotDist[n.id] != INF) stops.push_back(n.id);
+
+        vector<int> clusterVehicle;
+        for (size_t i = 0; i < vehicles.size(); ++i)
+            if (vehicles[i].capacity > 0) clusterVehicle.push_back(i);
+        int k = min(clusterVehicle.size(), stops.size());
+        if (k == 0) return assigned;
+
+        // Farthest-first seeds
+        vector<int> medoids;
+        medoidDist.assign(k, {});
+        vector<double> nearest = depotDist;
+        for (int c = 0; c < k; ++c) {
+            int far = -1;
+            for (int s : stops)
+                if (far == -1 || nearest[s] > nearest[far]) far = s;
+            medoids.push_back(far);
+            distancesFrom(workspaces[0], far, medoidDist[c]);
+            for (int s : stops) nearest[s] = min(nearest[s], medoidDist[c][s]);
+        }
+
+        vector<vector<int>> clusters;
+        vector<int> leftover;
+        for (iterations = 1;; ++iterations) {
+            assignStops(stops, medoids, vehicles, clusterVehicle, clusters, leftover);
+            if (iterations >= maxIterations) break;
+
+            vector<int> next(k);
+            pool.parallelFor(k, [&](size_t c, unsigned) { next[c] = medoidOf(clusters[c], medoids[c]); }, 1);
+            if (next == medoids) break;
+            for (int c = 0; c < k; ++c) {
+                if (next[c] == medoids[c]) continue;
+                medoids[c] = next[c];
+                medoidDist[c].clear();      // recomputed below
+            }
+            pool.parallelFor(k, [&](size_t c, unsigned w) {
+                if (medoidDist[c].empty()) distancesFrom(workspaces[w], medoids[c], medoidDist[c]);
+            }, 1);
+        }
+
+        // Route second: order each cluster on its own distance table
+        pool.parallelFor(k, [&](size_t c, unsigned) {
+            assigned[clusterVehicle[c]] = orderCluster(clusters[c]);
+        }, 1);
+
+        CapacityIndex fleet;
+        fleet.init(vehicles);
+        for (int c = 0; c < k; ++c)
+            for (int s : clusters[c]) fleet.take(clusterVehicle[c], graph.nodes[s].demand);
+        for (int s : leftover) {
+            int best = fleet.bestFit(graph.nodes[s].demand);
+            if (best == -1) continue;
+            fleet.take(best, graph.nodes[s].demand);
+            assigned[best].push_back(s);
+        }
+        return assigned;
+    }
+
+private:
+    vector<DijkstraWorkspace> workspaces;   // one per pool thread
+    vector<double> depotDist;
+    vector<vector<double>> medoidDist;      // medoid -> node -> distance
+
+    void distancesFrom(DijkstraWorkspace& ws, int source, vector<double>& dist) const {
+        graph.dijkstraSearch(ws, source, source, alpha, beta, false);
+        dist.resize(graph.N);
+        for (int v = 0; v < graph.N; ++v) dist[v] = ws.getDist(v);
+    }
+
+    void assignStops(const vector<int>& stops, const vector<int>& medoids, const vector<Vehicle>& vehicles,
+                     const vector<int>& clusterVehicle, vector<vector<int>>& clusters,
+                     vector<int>& leftover) const {
+        int k = medoids.size();
+        clusters.assign(k, {});
+        leftover.clear();
+        vector<int> room(k);
+        for (int c = 0; c < k; ++c) room[c] = vehicles[clusterVehicle[c]].capacity;
+
+        // Regret: how much a stop loses if it misses its nearest medoid
+        vector<double> regret(graph.N, 0.0);
+        for (int s : stops) {
+            double best = numeric_limits<double>::max(), second = best;
+            for (int c = 0; c < k; ++c) {
+                double d = medoidDist[c][s];
+                if (d < best) { second = best; best = d; }
+                else if (d < second) second = d;
+            }
+            regret[s] = second == numeric_limits<double>::max() ? 0.0 : second - best;
+        }
+
+        vector<int> order = stops;
+        stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            if (graph.nodes[a].priority != graph.nodes[b].priority)
+                return graph.nodes[a].priority > graph.nodes[b].priority;
+            return regret[a] > regret[b];
+        });
+
+        vector<int> byDist(k);
+        for (int s : order) {
+            for (int c = 0; c < k; ++c) byDist[c] = c;
+            sort(byDist.begin(), byDist.end(), [&](int a, int b) {
+                if (medoidDist[a][s] != medoidDist[b][s]) return medoidDist[a][s] < medoidDist[b][s];
+                return a < b;
+            });
+            int demand = graph.nodes[s].demand, chosen = -1;
+            for (int c : byDist) {
+                if (medoidDist[c][s] == numeric_limits<double>::max()) break;
+                if (room[c] >= demand) { chosen = c; break; }
+            }
+            if (chosen == -1) { leftover.push_back(s); continue; }
+            room[chosen] -= demand;
+            clusters[chosen].push_back(s);
+        }
+    }
+
+    // Lower bound on d(a, b) from the depot and medoid trees
+    double estimate(int a, int b) const {
+        const double INF = numeric_limits<double>::max();
+        double bound = fabs(depotDist[a] - depotDist[b]);
+        for (const vector<double>& d : medoidDist)
+            if (d[a] != INF && d[b] != INF) bound = max(bound, fabs(d[a] - d[b]));
+        return bound;
+    }
+
+    // Member with the smallest summed (estimated) distance to the
+    // others, summed over at most 64 evenly spaced members
+    int medoidOf(const vector<int>& members, int current) const {
+        size_t stride = max<size_t>(1, members.size() / 64);
+        int best = current;
+        double bestSum = numeric_limits<double>::max();
+        for (int x : members) {
+            double sum = 0.0;
+            for (size_t j = 0; j < members.size(); j += stride) sum += estimate(x, members[j]);
+            if (sum < bestSum || (sum == bestSum && x == current)) { bestSum = sum; best = x; }
+        }
+        return best;
+    }
+
+    vector<int> orderCluster(const vector<int>& members) const {
+        int m = members.size() + 2;
+        vector<double> table(size_t(m) * m, 0.0);
+        for (int i = 0; i < (int)members.size(); ++i) {
+            for (int j = 0; j < (int)members.size(); ++j)
+                if (i != j) table[size_t(i + 1) * m + j + 1] = estimate(members[i], members[j]);
+            double toDepot = depotDist[members[i]];
+            table[i + 1] = table[size_t(i + 1) * m] = toDepot;                      // depot as start
+            table[size_t(m - 1) * m + i + 1] = table[size_t(i + 1) * m + m - 1] = toDepot;   // and as end
+        }
+
+        StopOrdering ordering;
+        vector<int> out;
+        for (int p : ordering.order(table, m, false)) out.push_back(members[p - 1]);
+        return out;
+    }
+};
+
+#endif
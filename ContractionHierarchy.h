@@ -0,0 +1,404 @@
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include <vector>
+#include <queue>
+#include <limits>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <climits>
+#include "Graph.h"
+
+using namespace std;
+
+// ==========================================
+// Contraction Hierarchies for a fixed alpha/beta
+// Nodes are contracted in order of (lazily updated) edge difference;
+// a shortcut u - w through v is added unless a bounded witness search
+// finds a path no longer than w(u,v) + w(v,w) avoiding v. Queries run
+// a bidirectional upward search and unpack shortcuts recursively back
+// into the original node sequence.
+// Dense graphs fill in quickly, so contraction stops once the next node
+// has more than coreDegreeLimit live neighbours; the remaining core is
+// kept uncontracted with arcs in both directions and the query simply
+// runs bidirectional Dijkstra inside it.
+// The hierarchy snapshots edge availability at build time.
+// ==========================================
+struct ContractionHierarchy {
+    int N = 0;
+    double alpha = 1.0, beta = 1.0;
+    vector<int> rank;               // node -> contraction order
+
+    // Upward graph in CSR: arcs u -> v with rank[v] > rank[u], plus core arcs
+    vector<int> upOffset;
+    vector<int> upTo;
+    vector<double> upW;
+    vector<int> upMid;              // middle node of a shortcut, -1 for an original edge
+    vector<int> upEdge;             // graph edge id of an original arc (the cheapest parallel one), -1 for a shortcut
+
+    Bitset builtAvailable;          // edge availability the hierarchy was built on
+    unsigned builtVersion = 0;
+    unsigned builtWeightVersion = 0;
+    int shortcuts = 0;
+    int coreSize = 0;               // nodes left uncontracted
+    double buildMs = 0.0;
+
+    int witnessSettleLimit = 64;    // bound on each witness search (a quarter when estimating)
+    int coreDegreeLimit = 16;       // stop contracting above this live degree
+
+    bool empty() const { return N == 0; }
+
+    bool matches(const Graph& graph, double a, double b) const {
+        return N == graph.N && alpha == a && beta == b && builtWeightVersion == graph.weightVersion;
+    }
+
+    void build(const Graph& graph, double a, double b) {
+        auto t0 = chrono::steady_clock::now();
+        N = graph.N;
+        alpha = a;
+        beta = b;
+        builtAvailable = graph.edgeAvailable;
+        builtVersion = graph.availabilityVersion;
+        builtWeightVersion = graph.weightVersion;
+        shortcuts = 0;
+
+        g.assign(N, {});
+        for (int id = 0; id < (int)graph.edges.size(); ++id) {
+            if (!graph.edgeAvailable[id]) continue;
+            const Edge& e = graph.edges[id];
+            if (e.u == e.v) continue;
+            double w = alpha * e.cost + beta * (1.0 - e.reliability);
+            improveArc(e.u, e.v, w, -1, id);
+            improveArc(e.v, e.u, w, -1, id);
+        }
+
+        contracted.assign(N, false);
+        deletedNeighbors.assign(N, 0);
+        witnessDist.assign(N, 0.0);
+        witnessStamp.assign(N, 0);
+        witnessGen = 0;
+        rank.assign(N, -1);
+        vector<vector<CArc>> up(N);
+
+        // Lazy-update priority queue keyed by edge difference
+        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> order;
+        for (int v = 0; v < N; ++v) order.push({ priority(v), v });
+
+        int next = 0;
+        while (!order.empty()) {
+            int v = order.top().second; order.pop();
+            if (contracted[v]) continue;
+            int p = priority(v);
+            if (!order.empty() && p > order.top().first) {
+                order.push({ p, v });
+                continue;
+            }
+            if (p >= INT_MAX / 2) break;   // only core nodes left
+
+            rank[v] = next++;
+            contract(v, true);
+            for (const CArc& arc : g[v]) {
+                if (contracted[arc.to]) continue;
+                up[v].push_back(arc);
+                ++deletedNeighbors[arc.to];
+                removeArc(arc.to, v);
+            }
+            contracted[v] = true;
+            vector<CArc>().swap(g[v]);
+        }
+
+        // Core: rank above everything contracted, arcs kept both ways
+        coreSize = 0;
+        for (int v = 0; v < N; ++v) {
+            if (contracted[v]) continue;
+            rank[v] = next++;
+            ++coreSize;
+            for (const CArc& arc : g[v])
+                if (!contracted[arc.to]) up[v].push_back(arc);
+        }
+
+        upOffset.assign(N + 1, 0);
+        for (int v = 0; v < N; ++v) upOffset[v + 1] = upOffset[v] + up[v].size();
+        upTo.resize(upOffset[N]);
+        upW.resize(upOffset[N]);
+        upMid.resize(upOffset[N]);
+        upEdge.resize(upOffset[N]);
+        for (int v = 0; v < N; ++v) {
+            int k = upOffset[v];
+            for (const CArc& arc : up[v]) {
+                upTo[k] = arc.to;
+                upW[k] = arc.w;
+                upMid[k] = arc.mid;
+                upEdge[k] = arc.edge;
+                ++k;
+            }
+        }
+
+        g.clear();
+        vector<unsigned>().swap(witnessStamp);
+        vector<double>().swap(witnessDist);
+        buildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    }
+
+    // Upward (or core) arc between a and b, or -1
+    int findArc(int a, int b) const {
+        int lo = rank[a] < rank[b] ? a : b;
+        int hi = lo == a ? b : a;
+        for (int k = upOffset[lo]; k < upOffset[lo + 1]; ++k)
+            if (upTo[k] == hi) return k;
+        return -1;
+    }
+
+    // Append the original nodes of arc a -> b, excluding a, and the
+    // graph edge id of each step to `edges`
+    void unpack(int a, int b, vector<int>& out, vector<int>& edges) const {
+        vector<pair<int, int>> stack;
+        stack.push_back({ a, b });
+        while (!stack.empty()) {
+            auto [x, y] = stack.back(); stack.pop_back();
+            int k = findArc(x, y);
+            int mid = upMid[k];
+            if (mid == -1) {
+                out.push_back(y);
+                edges.push_back(upEdge[k]);
+            } else {
+                stack.push_back({ mid, y });   // second half last, so it unpacks after
+                stack.push_back({ x, mid });
+            }
+        }
+    }
+
+private:
+    struct CArc {
+        int to;
+        double w;
+        int mid;
+        int edge;                   // original arcs only, -1 for a shortcut
+    };
+
+    vector<vector<CArc>> g;         // remaining graph during contraction
+    vector<bool> contracted;
+    vector<int> deletedNeighbors;
+    vector<double> witnessDist;
+    vector<unsigned> witnessStamp;
+    unsigned witnessGen = 0;
+    vector<pair<double, int>> witnessHeap;
+
+    bool improveArc(int u, int v, double w, int mid, int edge = -1) {
+        for (CArc& arc : g[u]) {
+            if (arc.to != v) continue;
+            if (w >= arc.w) return false;
+            arc.w = w;
+            arc.mid = mid;
+            arc.edge = edge;
+            return true;
+        }
+        g[u].push_back({ v, w, mid, edge });
+        return true;
+    }
+
+    void removeArc(int u, int v) {
+        vector<CArc>& list = g[u];
+        for (size_t i = 0; i < list.size(); ++i) {
+            if (list[i].to != v) continue;
+            list[i] = list.back();
+            list.pop_back();
+            return;
+        }
+    }
+
+    int liveDegree(int v) const {
+        int degree = 0;
+        for (const CArc& arc : g[v]) if (!contracted[arc.to]) ++degree;
+        return degree;
+    }
+
+    int priority(int v) {
+        int degree = liveDegree(v);
+        if (degree > coreDegreeLimit) return INT_MAX / 2;   // core until neighbours go
+        return contract(v, false) - degree + 2 * deletedNeighbors[v];
+    }
+
+    // Shortcuts needed to contract v; added to g when apply is set
+    int contract(int v, bool apply) {
+        vector<CArc> nb;
+        for (const CArc& arc : g[v]) if (!contracted[arc.to]) nb.push_back(arc);
+
+        int added = 0;
+        for (size_t i = 0; i < nb.size(); ++i) {
+            if (i + 1 == nb.size()) break;
+            double maxW = 0.0;
+            for (size_t j = i + 1; j < nb.size(); ++j) maxW = max(maxW, nb[j].w);
+
+            witnessSearch(nb[i].to, v, nb[i].w + maxW, apply ? witnessSettleLimit : witnessSettleLimit / 4);
+            for (size_t j = i + 1; j < nb.size(); ++j) {
+                double via = nb[i].w + nb[j].w;
+                int w = nb[j].to;
+                if (witnessStamp[w] == witnessGen && witnessDist[w] <= via) continue;
+                ++added;
+                if (apply) {
+                    if (improveArc(nb[i].to, w, via, v)) ++shortcuts;
+                    improveArc(w, nb[i].to, via, v);
+                }
+            }
+        }
+        return added;
+    }
+
+    // Bounded Dijkstra from s in the remaining graph, skipping `avoid`
+    void witnessSearch(int s, int avoid, double limit, int settleLimit) {
+        if (++witnessGen == 0) {
+            fill(witnessStamp.begin(), witnessStamp.end(), 0);
+            witnessGen = 1;
+        }
+        vector<pair<double, int>>& pq = witnessHeap;   // min-heap, storage reused
+        pq.clear();
+        witnessStamp[s] = witnessGen;
+        witnessDist[s] = 0.0;
+        pq.push_back({ 0.0, s });
+        int settledCount = 0;
+
+        while (!pq.empty() && settledCount < settleLimit) {
+            pop_heap(pq.begin(), pq.end(), greater<pair<double, int>>());
+            auto [d, u] = pq.back(); pq.pop_back();
+            if (d > witnessDist[u]) continue;
+            if (d > limit) break;
+            ++settledCount;
+            for (const CArc& arc : g[u]) {
+                if (arc.to == avoid || contracted[arc.to]) continue;
+                double nd = d + arc.w;
+                if (nd > limit) continue;
+                if (witnessStamp[arc.to] != witnessGen || nd < witnessDist[arc.to]) {
+                    witnessStamp[arc.to] = witnessGen;
+                    witnessDist[arc.to] = nd;
+                    pq.push_back({ nd, arc.to });
+                    push_heap(pq.begin(), pq.end(), greater<pair<double, int>>());
+                }
+            }
+        }
+    }
+};
+
+// ==========================================
+// CH query engine
+// Paths found on the hierarchy stay optimal after edges are closed as
+// long as they avoid the closed edges (distances can only grow), so a
+// path is checked against current availability and the query falls
+// back to plain Dijkstra if it is blocked or if any edge was reopened.
+// ==========================================
+struct CHSearch {
+    const Graph& graph;
+    const ContractionHierarchy& ch;
+    DijkstraWorkspace fwd, bwd, fallback;
+    vector<int> path;               // last result, start excluded
+    vector<int> pathEdges;          // edge id of each step of a hierarchy path
+    int settled = 0;
+    int fallbacks = 0;              // queries answered by plain Dijkstra
+
+    CHSearch(const Graph& g, const ContractionHierarchy& h) : graph(g), ch(h) {}
+
+    bool search(int start, int end, double alpha, double beta) {
+        path.clear();
+        pathEdges.clear();
+        settled = 0;
+        refreshAvailability();
+        if (!anyReopened) {
+            if (!upwardSearch(start, end)) return false;   // closures never add paths
+            if (!anyClosed || pathOpen()) return true;
+            path.clear();
+        }
+
+        ++fallbacks;
+        if (!graph.dijkstraSearch(fallback, start, end, alpha, beta)) return false;
+        settled += fallback.settled;
+        fallback.appendPath(end, path);
+        return true;
+    }
+
+    void appendPath(vector<int>& out) const { out.insert(out.end(), path.begin(), path.end()); }
+
+private:
+    unsigned checkedVersion = 0;
+    bool checked = false;
+    bool anyClosed = false, anyReopened = false;
+
+    // Compare current availability with the build snapshot once per change
+    void refreshAvailability() {
+        if (checked && checkedVersion == graph.availabilityVersion) return;
+        checked = true;
+        checkedVersion = graph.availabilityVersion;
+        anyClosed = anyReopened = false;
+        if (checkedVersion == ch.builtVersion) return;
+        anyReopened = graph.edgeAvailable.hasBitsNotIn(ch.builtAvailable);
+        anyClosed = ch.builtAvailable.hasBitsNotIn(graph.edgeAvailable);
+    }
+
+    // The exact edges the hierarchy used, so a closed or open parallel
+    // edge next to them does not count
+    bool pathOpen() const {
+        for (int id : pathEdges)
+            if (!graph.edgeAvailable[id]) return false;
+        return true;
+    }
+
+    bool upwardSearch(int start, int end) {
+        fwd.reset(graph.N);
+        bwd.reset(graph.N);
+        init(fwd, start);
+        init(bwd, end);
+        double best = numeric_limits<double>::max();
+        int meet = -1;
+
+        while (true) {
+            bool fOpen = !fwd.heap.empty() && fwd.heap.front().effCost < best;
+            bool bOpen = !bwd.heap.empty() && bwd.heap.front().effCost < best;
+            if (!fOpen && !bOpen) break;
+
+            bool forward = fOpen && (!bOpen || fwd.heap.front().effCost <= bwd.heap.front().effCost);
+            DijkstraWorkspace& ws = forward ? fwd : bwd;
+            const DijkstraWorkspace& other = forward ? bwd : fwd;
+
+            SearchState top = ws.pop();
+            int u = top.u;
+            if (top.effCost > ws.dist[u]) continue;
+            ++ws.settled;
+
+            double od = other.getDist(u);
+            if (od != numeric_limits<double>::max() && top.effCost + od < best) {
+                best = top.effCost + od;
+                meet = u;
+            }
+
+            for (int k = ch.upOffset[u]; k < ch.upOffset[u + 1]; ++k) {
+                int v = ch.upTo[k];
+                double nd = ws.dist[u] + ch.upW[k];
+                ws.touch(v);
+                if (nd < ws.dist[v]) {
+                    ws.dist[v] = nd;
+                    ws.parent[v] = u;
+                    ws.push({ nd, v, 1.0 });
+                }
+            }
+        }
+
+        settled = fwd.settled + bwd.settled;
+        if (meet == -1) return false;
+
+        // start -> meet: collect the upward chain, then unpack in order
+        vector<int> chain;
+        for (int v = meet; v != -1; v = fwd.parent[v]) chain.push_back(v);
+        for (size_t i = chain.size() - 1; i > 0; --i) ch.unpack(chain[i], chain[i - 1], path, pathEdges);
+        // meet -> end: walk the backward tree down
+        for (int v = meet; bwd.parent[v] != -1; v = bwd.parent[v]) ch.unpack(v, bwd.parent[v], path, pathEdges);
+        return true;
+    }
+
+    static void init(DijkstraWorkspace& ws, int s) {
+        ws.touch(s);
+        ws.dist[s] = 0;
+        ws.push({ 0.0, s, 1.0 });
+    }
+};
+
+#endif
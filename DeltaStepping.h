@@ -0,0 +1,153 @@
+#ifndef DELTASTEPPING_H
+#define DELTASTEPPING_H
+
+#include <vector>
+#include <limits>
+#include "Graph.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+// ==========================================
+// Parallel delta-stepping single-source shortest paths
+// Nodes are kept in buckets of width delta by tentative distance. The
+// current bucket is settled in rounds: its light edges (w <= delta) are
+// relaxed in parallel, then heavy edges once the bucket is empty.
+// Each round has two phases so no lock is needed. First every worker
+// scans part of the frontier and files (v, dist, parent) requests by
+// v's partition. Then every worker applies the requests for its own
+// partition. Ties on equal distance go to the smaller parent id, so the
+// result does not depend on thread count or scheduling. dist matches
+// Dijkstra's; parents may differ only between equal-cost paths.
+// ==========================================
+struct DeltaStepping {
+    const Graph& graph;
+    ThreadPool& pool;
+    double delta = 0.0;             // bucket width; 0 = mean effective edge weight
+    vector<double> dist;
+    vector<int> parent;
+    int rounds = 0;                 // light + heavy relaxation rounds of the last run
+
+    DeltaStepping(const Graph& g, ThreadPool& p) : graph(g), pool(p) {}
+
+    void run(int source, double alpha = 1.0, double beta = 1.0) {
+        const double INF = numeric_limits<double>::max();
+        int N = graph.N;
+        unsigned P = pool.size();
+        a = alpha;
+        b = beta;
+        dist.assign(N, INF);
+        parent.assign(N, -1);
+        frontierStamp.assign(N, 0);
+        heavyStamp.assign(N, 0);
+        epoch = 0;
+        rounds = 0;
+        width = delta > 0.0 ? delta : meanWeight();
+        requests.assign(P, vector<vector<Request>>(P));
+        inserted.assign(P, {});
+        buckets.assign(1, {});
+
+        dist[source] = 0.0;
+        buckets[0].push_back(source);
+
+        vector<int> frontier, settledHere, current;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            settledHere.clear();
+            ++epoch;
+            unsigned heavyTag = epoch;
+            while (!buckets[i].empty()) {
+                current.swap(buckets[i]);
+                buckets[i].clear();
+                frontier.clear();
+                ++epoch;
+                for (int v : current) {
+                    if (frontierStamp[v] == epoch || bucketOf(dist[v]) != i) continue;
+                    frontierStamp[v] = epoch;
+                    frontier.push_back(v);
+                    if (heavyStamp[v] != heavyTag) {
+                        heavyStamp[v] = heavyTag;
+                        settledHere.push_back(v);
+                    }
+                }
+                relax(frontier, true);
+            }
+            relax(settledHere, false);
+        }
+    }
+
+private:
+    struct Request {
+        int v;
+        double d;
+        int u;
+    };
+
+    double a = 1.0, b = 1.0, width = 1.0;
+    vector<vector<int>> buckets;
+    vector<vector<vector<Request>>> requests;   // [worker][partition]
+    vector<vector<int>> inserted;               // [partition] nodes whose dist dropped
+    vector<unsigned> frontierStamp, heavyStamp;
+    unsigned epoch = 0;
+
+    size_t bucketOf(double d) const { return size_t(d / width); }
+
+    double weight(int k) const { return a * graph.csrCost[k] + b * (1.0 - graph.csrRel[k]); }
+
+    double meanWeight() const {
+        double sum = 0.0;
+        int n = 0;
+        for (int k = 0; k < (int)graph.csrTo.size(); ++k) {
+            if (!graph.arcAvailable[k]) continue;
+            sum += weight(k);
+            ++n;
+        }
+        return n > 0 && sum > 0.0 ? sum / n : 1.0;
+    }
+
+    void relax(const vector<int>& nodes, bool light) {
+        if (nodes.empty()) return;
+        ++rounds;
+        unsigned P = pool.size();
+
+        // Phase 1: scan edges, file requests by target partition
+        pool.parallelFor(nodes.size(), [&](size_t i, unsigned w) {
+            int u = nodes[i];
+            double du = dist[u];
+            for (int k = graph.csrOffset[u]; k < graph.csrOffset[u + 1]; ++k) {
+                if (!graph.arcAvailable[k]) continue;
+                double wt = weight(k);
+                if ((wt <= width) != light) continue;
+                int v = graph.csrTo[k];
+                double nd = du + wt;
+                if (nd <= dist[v]) requests[w][v % P].push_back({ v, nd, u });
+            }
+        }, 32);
+
+        // Phase 2: each worker owns the nodes of one partition
+        pool.run([&](unsigned p) {
+            for (unsigned w = 0; w < P; ++w) {
+                for (const Request& r : requests[w][p]) {
+                    if (r.d < dist[r.v]) {
+                        dist[r.v] = r.d;
+                        parent[r.v] = r.u;
+                        inserted[p].push_back(r.v);
+                    } else if (r.d == dist[r.v] && r.u < parent[r.v]) {
+                        parent[r.v] = r.u;
+                    }
+                }
+                requests[w][p].clear();
+            }
+        });
+
+        for (auto& list : inserted) {
+            for (int v : list) {
+                size_t i = bucketOf(dist[v]);
+                if (i >= buckets.size()) buckets.resize(i + 1);
+                buckets[i].push_back(v);
+            }
+            list.clear();
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef DIJKSTRAKERNELS_H
+#define DIJKSTRAKERNELS_H
+
+#include <vector>
+#include <limits>
+#include <type_traits>
+#include "Graph.h"
+
+using namespace std;
+
+// ==========================================
+// Compile-time specialised Dijkstra kernels
+// The objective is a policy type, so the degenerate weightings compile
+// to loops without the unused half of alpha * cost + beta * (1 - rel):
+//   CostOnlyPolicy        - beta = 0: integer costs, integer labels,
+//                           Dial bucket queue; no reliability work
+//   ReliabilityOnlyPolicy - alpha = 0: sum of (1 - rel), the generic
+//                           objective with beta factored out
+//   WeightedPolicy        - the general case (Graph::runDijkstra)
+// Only WeightedPolicy breaks equal-cost ties on reliability.
+// ==========================================
+
+// Dial's bucket queue for integer keys with edge weights <= maxWeight:
+// pending keys always lie in [cur, cur + maxWeight], so maxWeight + 1
+// circular buckets suffice. Stale entries are skipped by the caller.
+struct BucketQueue {
+    vector<vector<pair<long long, int>>> buckets;
+    long long cur = 0;
+    size_t count = 0;
+    HeapStats stats;
+
+    void reset(int maxWeight) {
+        if ((int)buckets.size() != maxWeight + 1) buckets.assign(maxWeight + 1, {});
+        else for (auto& b : buckets) b.clear();
+        cur = 0;
+        count = 0;
+        stats = HeapStats();
+    }
+
+    bool empty() const { return count == 0; }
+
+    void push(long long key, int v) {
+        ++stats.pushes;
+        buckets[key % buckets.size()].push_back({ key, v });
+        ++count;
+    }
+
+    pair<long long, int> pop() {
+        ++stats.pops;
+        while (buckets[cur % buckets.size()].empty()) ++cur;
+        auto& b = buckets[cur % buckets.size()];
+        pair<long long, int> top = b.back();
+        b.pop_back();
+        --count;
+        return top;
+    }
+};
+
+// Binary min-heap of (label, node) for the plain double-valued kernel
+struct PairHeap {
+    vector<pair<double, int>> data;
+    HeapStats stats;
+
+    void reset(int) { data.clear(); stats = HeapStats(); }
+    bool empty() const { return data.empty(); }
+
+    void push(double key, int v) {
+        ++stats.pushes;
+        data.push_back({ key, v });
+        push_heap(data.begin(), data.end(), greater<pair<double, int>>());
+    }
+
+    pair<double, int> pop() {
+        ++stats.pops;
+        pop_heap(data.begin(), data.end(), greater<pair<double, int>>());
+        pair<double, int> top = data.back();
+        data.pop_back();
+        return top;
+    }
+};
+
+struct CostOnlyPolicy {
+    using Dist = long long;
+    using Queue = BucketQueue;
+    static Dist weight(const Graph& g, int k) { return g.csrCost[k]; }
+    static int queueSize(const Graph& g) { return g.maxCost; }
+};
+
+struct ReliabilityOnlyPolicy {
+    using Dist = double;
+    using Queue = PairHeap;
+    static Dist weight(const Graph& g, int k) { return 1.0 - g.csrRel[k]; }
+    static int queueSize(const Graph& g) { return g.N; }
+};
+
+struct WeightedPolicy {
+    using Dist = double;
+    using Queue = BinaryHeap;
+};
+
+// Point-to-point search under Policy; fills ws and returns whether end is reachable
+template <class Policy>
+bool dijkstraKernel(const Graph& graph, BasicDijkstraWorkspace<typename Policy::Dist>& ws,
+                    typename Policy::Queue& queue, int start, int end,
+                    double alpha = 1.0, double beta = 1.0) {
+    if constexpr (is_same<Policy, WeightedPolicy>::value) {
+        return graph.dijkstraSearchWith(ws, queue, start, end, alpha, beta);
+    } else {
+        assert(graph.frozen && "Graph::freeze() must run after the last addEdge");
+        using Dist = typename Policy::Dist;
+        const Dist INF = numeric_limits<Dist>::max();
+        ws.reset(graph.N);
+        queue.reset(Policy::queueSize(graph));
+        ws.touch(start);
+        ws.dist[start] = 0;
+        queue.push(0, start);
+
+        while (!queue.empty()) {
+            auto [d, u] = queue.pop();
+            if (d > ws.dist[u]) { ++queue.stats.stalePops; continue; }
+            ++ws.settled;
+            if (u == end) break;
+
+            for (int k = graph.csrOffset[u]; k < graph.csrOffset[u + 1]; ++k) {
+                if (!graph.arcAvailable[k]) continue;
+                Dist w = Policy::weight(graph, k);
+                int v = graph.csrTo[k];
+                Dist nd = d + w;
+                ws.touch(v);
+                if (nd < ws.dist[v]) {
+                    ws.dist[v] = nd;
+                    ws.parent[v] = u;
+                    queue.push(nd, v);
+                }
+            }
+        }
+        return ws.getDist(end) != INF;
+    }
+}
+
+#endif
@@ -7,24 +7,250 @@
 #include <algorithm>
 #include <climits>
 #include <unordered_set>
+#include <memory>
 #include "Graph.h"
 #include "vehicle.h"
+#include "DistanceMatrix.h"
+#include "Bidirectional.h"
+#include "ALT.h"
+#include "ContractionHierarchy.h"
+#include "CCH.h"
+#include "DijkstraKernels.h"
+#include "Pareto.h"
+#include "ThreadPool.h"
+#include "StopOrdering.h"
+#include "Savings.h"
+#include "CapacityIndex.h"
+#include "Cluster.h"
+#include "ALNS.h"
+#include "DynamicSSSP.h"
+#include <chrono>
 #include <cmath>
 
 
 using namespace std;
 
+// Point-to-point query engine used for route legs
+enum class RouteEngine { Dijkstra, Bidirectional, ALT, CH, CCH };
+
+// Priority queue used by the Dijkstra engine (see Heaps.h)
+enum class HeapKind { Binary, Quaternary, Radix };
+
+// How stops are split between vehicles
+enum class Allocator { BestFit, Savings, Cluster };
+
+// Plan summary printed by computeMetrics
+struct PlanMetrics {
+    int totalCost = 0;
+    double avgReliability = 0.0;
+    double prioritySatisfaction = 0.0;
+    int idleVehicles = 0;
+    double utilization = 0.0;       // percent of total fleet capacity
+};
+
+// Outcome of DisasterManager::replanClosures
+struct ReplanResult {
+    int vehiclesAffected = 0;
+    int legsRerouted = 0;
+    int stopsDropped = 0;           // no longer reachable from where the vehicle is
+    vector<int> droppedStops;       // their node ids; they stay assigned with stopIndex -1
+    int treeNodesRepaired = 0;      // depot tree entries re-settled
+    int matrixRowsRefreshed = 0;    // stop table rows recomputed
+};
+
+// One row of a weighting sweep
+struct SweepResult {
+    double alpha, beta;
+    PlanMetrics metrics;
+    double routingMs;
+};
+
+// Query state for route legs, one per routing thread. The indexes it
+// searches (landmarks, hierarchy, CCH) are shared read-only.
+struct RouteWorker {
+    DijkstraWorkspace workspace;
+    BidirectionalDijkstra bidir;
+    ALTSearch alt;
+    CHSearch chSearch;
+    CCHSearch cchSearch;
+    QuaternaryHeap quadHeap;
+    RadixHeap radixHeap;
+    BasicDijkstraWorkspace<long long> costWorkspace;
+    BucketQueue bucketQueue;
+    PairHeap pairHeap;
+    HeapStats heapStats;            // since last collected by the manager
+    long long settled = 0;
+
+    RouteWorker(const Graph& g, const LandmarkIndex& lm, const ContractionHierarchy& ch,
+                const CustomizableCH& cch)
+        : bidir(g), alt(g, lm), chSearch(g, ch), cchSearch(g, cch) {}
+};
+
 struct DisasterManager {
     Graph &graph;
     vector<Vehicle> &vehicles;
-
-    DisasterManager(Graph &g, vector<Vehicle> &v) : graph(g), vehicles(v) {}
+    LandmarkIndex landmarks;       // ALT preprocessing, built or loaded on demand
+    int landmarkCount = 8;
+    string landmarkCachePath;      // reuse/persist the landmark index here when set
+    ContractionHierarchy hierarchy;
+    CustomizableCH cch;            // order built once, re-customized after closures
+
+    RouteEngine engine = RouteEngine::Dijkstra;
+    HeapKind heapKind = HeapKind::Binary;
+    HeapStats heapTotals;          // summed over Dijkstra-engine legs
+
+    // beta = 0 / alpha = 0 legs use the specialised kernels unless disabled
+    bool specializeKernels = true;
+    long long settledNodes = 0;    // nodes settled by route-leg queries so far
+
+    // Vehicles are routed in parallel, one RouteWorker per thread;
+    // router is worker 0 and serves single legs outside buildRoutes
+    unsigned routeThreads = 0;     // 0 = every hardware thread
+    RouteWorker router;
+    vector<unique_ptr<RouteWorker>> extraWorkers;
+
+    Allocator allocator = Allocator::BestFit;
+    int savingsNeighbours = 10;    // nearest stops per stop considered by Savings
+
+    double alpha = 1.0;            // routing weight for cost
+    double beta = 1.0;             // routing weight for unreliability
+
+    // Optional stop x stop cost table (depot + demand nodes), built in
+    // allocateAndRoute; legs it reports unreachable are never searched.
+    bool useStopMatrix = false;
+    size_t stopMatrixBudget = size_t(512) << 20;   // bytes
+    unsigned stopMatrixThreads = 0;                // 0 = every hardware thread
+    DistanceMatrix stopCosts;
+
+    // Reorder each vehicle's stops (nearest neighbour + 2-opt / Or-opt)
+    // on the stop table before routing; strict keeps priority classes in
+    // order and only reorders stops of equal priority
+    bool optimizeStopOrder = false;
+    bool strictPriorityOrder = false;
+    StopOrdering stopOrdering;
+
+    // ALNS improvement of the stop lists after allocation / ordering;
+    // 0 ms turns it off
+    double improveBudgetMs = 0.0;
+    unsigned improveThreads = 1;
+    ALNSStats improveStats;
+
+    ParetoRouter pareto;           // cost / reliability frontier queries, see routeOptions
+
+    // Depot shortest-path tree, kept current by replanClosures; broken
+    // return-to-depot legs are read from it instead of searched
+    ShortestPathTree depotTree;
+    unsigned depotTreeVersion = 0;  // graph.availabilityVersion it matches
+
+    DisasterManager(Graph &g, vector<Vehicle> &v) : graph(g), vehicles(v),
+          router(g, landmarks, hierarchy, cch), pareto(g) {
+        if (!graph.frozen) graph.freeze();
+    }
 
     // ==========================================
     // MAIN ALLOCATION METHOD
     // Uses Best-Fit Decreasing for optimal long-term performance
     // ==========================================
     void allocateAndRoute() {
+        vector<vector<int>> assignedNodes = allocate();
+        plan(assignedNodes);
+    }
+
+    // ==========================================
+    // Helper: Everything after allocation that depends on alpha / beta
+    // ==========================================
+    void plan(vector<vector<int>> assignedNodes) {
+        prepareEngine();
+        if (useStopMatrix || optimizeStopOrder || improveBudgetMs > 0) buildStopMatrix();
+        if (optimizeStopOrder) orderStops(assignedNodes);
+        if (improveBudgetMs > 0) improvePlan(assignedNodes);
+
+        // Build routes using multi-objective Dijkstra
+        buildRoutes(assignedNodes);
+    }
+
+    // ==========================================
+    // WEIGHTING SWEEP
+    // Plans once per (alpha, beta) pair on the same loaded graph and
+    // (for Best-Fit, which ignores the weights) the same allocation.
+    // Each configuration gets its own fleet copy and routing state and
+    // runs on a pool worker. Engine settings are copied from this
+    // manager; the landmark cache is not shared.
+    // Results come back in input order. Routes are left untouched.
+    // ==========================================
+    vector<SweepResult> sweep(const vector<pair<double, double>>& weights, unsigned threads = 0) const {
+        bool sharedAllocation = allocator == Allocator::BestFit;
+        vector<vector<int>> assignedNodes;
+        if (sharedAllocation) assignedNodes = allocate();
+        vector<SweepResult> results(weights.size());
+
+        ThreadPool pool(min<size_t>(threads ? threads : thread::hardware_concurrency(),
+                                    max<size_t>(1, weights.size())));
+        pool.parallelFor(weights.size(), [&](size_t i, unsigned) {
+            vector<Vehicle> fleet = vehicles;
+            DisasterManager dm(graph, fleet);
+            dm.engine = engine;
+            dm.heapKind = heapKind;
+            dm.specializeKernels = specializeKernels;
+            dm.landmarkCount = landmarkCount;
+            dm.useStopMatrix = useStopMatrix;
+            dm.stopMatrixBudget = stopMatrixBudget;
+            dm.stopMatrixThreads = 1;
+            dm.stopCosts.deltaStepping = stopCosts.deltaStepping;
+            dm.stopCosts.trackClosures = stopCosts.trackClosures;
+            dm.routeThreads = 1;
+            dm.alpha = weights[i].first;
+            dm.beta = weights[i].second;
+
+            dm.optimizeStopOrder = optimizeStopOrder;
+            dm.strictPriorityOrder = strictPriorityOrder;
+            dm.allocator = allocator;
+            dm.savingsNeighbours = savingsNeighbours;
+            dm.improveBudgetMs = improveBudgetMs;
+            dm.improveThreads = 1;
+
+            auto t0 = chrono::steady_clock::now();
+            dm.plan(sharedAllocation ? assignedNodes : dm.allocate());
+            auto t1 = chrono::steady_clock::now();
+
+            results[i] = { dm.alpha, dm.beta, dm.measure(),
+                           chrono::duration<double, milli>(t1 - t0).count() };
+        }, 1);
+        return results;
+    }
+
+    // ==========================================
+    // Helper: Clarke-Wright savings allocation (Savings.h)
+    // Depends on alpha / beta through the stop distances
+    // ==========================================
+    vector<vector<int>> savingsAllocate() const {
+        SavingsAllocator savings(graph);
+        savings.alpha = alpha;
+        savings.beta = beta;
+        savings.kNearest = savingsNeighbours;
+        return savings.allocate(vehicles);
+    }
+
+    // ==========================================
+    // Helper: Cluster-first allocation (Cluster.h), stops already
+    // ordered within each vehicle's cluster
+    // ==========================================
+    vector<vector<int>> clusterAllocate() const {
+        ClusterAllocator clustering(graph);
+        clustering.alpha = alpha;
+        clustering.beta = beta;
+        clustering.threads = routeThreads;
+        return clustering.allocate(vehicles);
+    }
+
+    // ==========================================
+    // Helper: Best-Fit Decreasing assignment of nodes to vehicles
+    // Independent of alpha / beta, so a sweep computes it once
+    // ==========================================
+    vector<vector<int>> allocate() const {
+        if (allocator == Allocator::Savings) return savingsAllocate();
+        if (allocator == Allocator::Cluster) return clusterAllocate();
+
         vector<Node> nodes;
         for (const Node& n : graph.nodes)
             if (n.id != 0) nodes.push_back(n);
@@ -37,9 +263,8 @@ struct DisasterManager {
         });
 
         vector<bool> nodeAssigned(graph.nodes.size(), false);
-        vector<int> remainingCap(vehicles.size());
-        for (size_t i = 0; i < vehicles.size(); ++i) 
-            remainingCap[i] = vehicles[i].capacity;
+        CapacityIndex fleet;        // remaining capacities, ordered
+        fleet.init(vehicles);
 
         vector<vector<int>> assignedNodes(vehicles.size());
 
@@ -48,85 +273,382 @@ struct DisasterManager {
         for (auto& node : nodes) {
             if (nodeAssigned[node.id]) continue;
 
-            int bestVehicle = -1;
-            int minRemainingCap = INT_MAX;
-            
-            // Find vehicle with tightest fit
-            for (size_t i = 0; i < vehicles.size(); ++i) {
-                if (remainingCap[i] >= node.demand && remainingCap[i] < minRemainingCap) {
-                    bestVehicle = i;
-                    minRemainingCap = remainingCap[i];
-                }
-            }
+            // Tightest fit by lower_bound, O(log V)
+            int bestVehicle = fleet.bestFit(node.demand);
 
             if (bestVehicle != -1) {
                 assignedNodes[bestVehicle].push_back(node.id);
-                remainingCap[bestVehicle] -= node.demand;
+                fleet.take(bestVehicle, node.demand);
                 nodeAssigned[node.id] = true;
             }
         }
+        return assignedNodes;
+    }
 
-        // Build routes using multi-objective Dijkstra
-        for (size_t i = 0; i < vehicles.size(); ++i) {
-            vehicles[i].assignedNodes = assignedNodes[i];
-            
-            if (assignedNodes[i].empty()) {
-                vehicles[i].route.clear();
+    // ==========================================
+    // ROUTE OPTIONS
+    // Every cost / reliability tradeoff between two nodes, cheapest
+    // first, so a route can be picked by policy instead of rerunning
+    // with different alpha / beta
+    // ==========================================
+    vector<ParetoRoute> routeOptions(int from, int to) {
+        return pareto.search(from, to);
+    }
+
+    // ==========================================
+    // Helper: Preprocessing required by the selected engine
+    // ==========================================
+    void prepareEngine() {
+        if (engine == RouteEngine::CH && !hierarchy.matches(graph, alpha, beta))
+            hierarchy.build(graph, alpha, beta);
+        if (engine == RouteEngine::CCH) {
+            if (cch.N != graph.N) cch.buildOrder(graph);
+            if (cch.needsCustomization(graph, alpha, beta)) cch.customize(graph, alpha, beta);
+        }
+        if (engine != RouteEngine::ALT) return;
+        if (landmarks.matches(graph, landmarkCount, alpha, beta)) return;
+        if (!landmarkCachePath.empty() &&
+            landmarks.load(landmarkCachePath, graph, landmarkCount, alpha, beta))
+            return;
+
+        landmarks.build(graph, landmarkCount, alpha, beta);
+        if (!landmarkCachePath.empty() && !landmarks.save(landmarkCachePath))
+            cerr << "Warning: could not write landmark cache " << landmarkCachePath << "\n";
+    }
+
+    // ==========================================
+    // Helper: Precompute stop x stop costs (depot first)
+    // ==========================================
+    void buildStopMatrix() {
+        vector<int> stops;
+        stops.push_back(0);
+        for (const Node& n : graph.nodes)
+            if (n.id != 0) stops.push_back(n.id);
+        stopCosts.build(graph, stops, alpha, beta, stopMatrixBudget, stopMatrixThreads);
+    }
+
+    // ==========================================
+    // Helper: Reorder each vehicle's stops on the stop table
+    // Assignment lists arrive in non-increasing priority, so in strict
+    // mode each run of equal priority is ordered as an open path that
+    // starts where the previous run ended.
+    // ==========================================
+    void orderStops(vector<vector<int>>& assignedNodes) {
+        for (auto& stops : assignedNodes) {
+            if (!strictPriorityOrder) {
+                stops = orderPath(0, stops, 0);
                 continue;
             }
+            vector<int> ordered;
+            for (size_t i = 0, j; i < stops.size(); i = j) {
+                int priority = graph.nodes[stops[i]].priority;
+                for (j = i; j < stops.size() && graph.nodes[stops[j]].priority == priority; ++j) {}
+                vector<int> group(stops.begin() + i, stops.begin() + j);
+                int from = ordered.empty() ? 0 : ordered.back();
+                group = orderPath(from, group, j == stops.size() ? 0 : -1);
+                ordered.insert(ordered.end(), group.begin(), group.end());
+            }
+            stops = ordered;
+        }
+    }
 
-            vector<int> fullRoute;
-            fullRoute.push_back(0); // Start at depot
+    // `stops` ordered on a path from -> to; to = -1 leaves the end open
+    vector<int> orderPath(int from, const vector<int>& stops, int to) {
+        int m = stops.size() + 2;
+        vector<int> point(1, from);
+        point.insert(point.end(), stops.begin(), stops.end());
+        point.push_back(to == -1 ? from : to);
+
+        vector<double> table(size_t(m) * m);
+        for (int i = 0; i < m; ++i)
+            for (int j = 0; j < m; ++j)
+                table[size_t(i) * m + j] = min(stopCosts.cost(point[i], point[j]), 1e12);   // unreachable
+
+        vector<int> out;
+        for (int k : stopOrdering.order(table, m, to == -1)) out.push_back(stops[k - 1]);
+        return out;
+    }
 
-            for (int nid : assignedNodes[i]) {
-                vector<int> path = graph.dijkstraMultiObjective(fullRoute.back(), nid);
-                if (path.empty()) continue;
-                path.erase(path.begin());
-                fullRoute.insert(fullRoute.end(), path.begin(), path.end());
+    // ==========================================
+    // Helper: ALNS over the stop lists on the stop table (ALNS.h)
+    // ==========================================
+    void improvePlan(vector<vector<int>>& assignedNodes) {
+        int K = stopCosts.size();
+        const vector<int>& stops = stopCosts.stops;     // depot first
+        vector<double> table(size_t(K) * K);
+        vector<int> demand(K, 0), priority(K, 0), capacity;
+        for (int i = 0; i < K; ++i) {
+            if (i > 0) {
+                demand[i] = graph.nodes[stops[i]].demand;
+                priority[i] = graph.nodes[stops[i]].priority;
             }
+            for (int j = 0; j < K; ++j)
+                table[size_t(i) * K + j] = min(stopCosts.cost(stops[i], stops[j]), 1e12);   // unreachable
+        }
+        for (const Vehicle& v : vehicles) capacity.push_back(v.capacity);
+
+        vector<vector<int>> routes(assignedNodes.size());
+        for (size_t r = 0; r < assignedNodes.size(); ++r) {
+            for (int node : assignedNodes[r]) routes[r].push_back(stopCosts.index[node]);
+            if (strictPriorityOrder)        // ALNS keeps, but does not establish, the order
+                stable_sort(routes[r].begin(), routes[r].end(),
+                            [&](int a, int b) { return priority[a] > priority[b]; });
+        }
 
-            // Return to depot
-            vector<int> returnPath = graph.dijkstraMultiObjective(fullRoute.back(), 0);
-            if (!returnPath.empty()) {
-                returnPath.erase(returnPath.begin());
-                fullRoute.insert(fullRoute.end(), returnPath.begin(), returnPath.end());
-            }
+        ALNS search;
+        search.timeBudgetMs = improveBudgetMs;
+        search.threads = improveThreads;
+        search.strictPriority = strictPriorityOrder;
+        search.improve(table, K, demand, priority, capacity, routes);
+        improveStats = search.stats;
+
+        for (size_t r = 0; r < routes.size(); ++r) {
+            assignedNodes[r].clear();
+            for (int s : routes[r]) assignedNodes[r].push_back(stops[s]);
+        }
+    }
 
-            vehicles[i].route = fullRoute;
+    // Shortest leg from -> to appended to route; false if unreachable
+    bool appendLeg(int from, int to, vector<int>& route) {
+        if (engine == RouteEngine::CCH && cch.needsCustomization(graph, alpha, beta))
+            cch.customize(graph, alpha, beta);
+        bool found = appendLeg(router, from, to, route);
+        collectStats();
+        return found;
+    }
+
+    // Same, on a given worker's query state. Touches nothing shared, so
+    // workers may run it concurrently.
+    bool appendLeg(RouteWorker& w, int from, int to, vector<int>& route) {
+        if (!stopCosts.empty() && stopCosts.has(from) && stopCosts.has(to) &&
+            !stopCosts.reachable(from, to))
+            return false;
+
+        switch (engine) {
+        case RouteEngine::CCH:
+            if (!w.cchSearch.search(from, to)) break;
+            w.cchSearch.appendPath(route);
+            w.settled += w.cchSearch.settled;
+            return true;
+        case RouteEngine::CH:
+            if (!w.chSearch.search(from, to, alpha, beta)) break;
+            w.chSearch.appendPath(route);
+            w.settled += w.chSearch.settled;
+            return true;
+        case RouteEngine::ALT:
+            if (!w.alt.search(from, to)) break;
+            w.alt.appendPath(to, route);
+            w.settled += w.alt.settled;
+            return true;
+        case RouteEngine::Bidirectional:
+            if (!w.bidir.search(from, to, alpha, beta)) break;
+            w.bidir.appendPath(route);
+            w.settled += w.bidir.settled;
+            return true;
+        default:
+            return dijkstraLeg(w, from, to, route);
+        }
+        return false;
+    }
+
+    // Dijkstra engine: a specialised kernel when one weight is zero,
+    // otherwise the weighted search with the configured heap. The radix
+    // heap needs integer keys, so it is only used for beta = 0 and
+    // integral alpha.
+    bool dijkstraLeg(RouteWorker& w, int from, int to, vector<int>& route) {
+        if (specializeKernels && beta == 0.0 && alpha > 0.0)
+            return kernelLeg<CostOnlyPolicy>(w, w.costWorkspace, w.bucketQueue, from, to, route);
+        if (specializeKernels && alpha == 0.0 && beta > 0.0)
+            return kernelLeg<ReliabilityOnlyPolicy>(w, w.workspace, w.pairHeap, from, to, route);
+
+        switch (heapKind) {
+        case HeapKind::Radix:
+            if (beta == 0.0 && alpha == floor(alpha))
+                return kernelLeg<WeightedPolicy>(w, w.workspace, w.radixHeap, from, to, route);
+            return kernelLeg<WeightedPolicy>(w, w.workspace, w.quadHeap, from, to, route);
+        case HeapKind::Quaternary:
+            return kernelLeg<WeightedPolicy>(w, w.workspace, w.quadHeap, from, to, route);
+        default:
+            return kernelLeg<WeightedPolicy>(w, w.workspace, w.workspace.heap, from, to, route);
         }
     }
 
-   
+    template <class Policy, class Workspace, class Queue>
+    bool kernelLeg(RouteWorker& w, Workspace& ws, Queue& queue, int from, int to, vector<int>& route) {
+        bool found;
+        if constexpr (is_same<Policy, WeightedPolicy>::value)
+            found = graph.dijkstraSearchWith(ws, queue, from, to, alpha, beta);
+        else
+            found = dijkstraKernel<Policy>(graph, ws, queue, from, to, alpha, beta);
+        w.heapStats += queue.stats;
+        w.settled += ws.settled;
+        if (found) ws.appendPath(to, route);
+        return found;
+    }
+
+    // ==========================================
+    // Helper: Route one vehicle through its stops
+    // depot -> stops... -> depot, paths appended in place
+    // ==========================================
+    void buildRoute(RouteWorker& w, const vector<int>& stops, vector<int>& route, vector<int>& stopIndex) {
+        route.clear();
+        stopIndex.clear();
+        if (stops.empty()) return;
+
+        route.push_back(0); // Start at depot
+
+        for (int nid : stops)
+            stopIndex.push_back(appendLeg(w, route.back(), nid, route) ? (int)route.size() - 1 : -1);
+
+        // Return to depot
+        appendLeg(w, route.back(), 0, route);
+    }
 
     // ==========================================
     // Helper: Build Routes from Assignments
+    // Vehicles are independent, so they are spread over a thread pool,
+    // longest stop list first. Every route is written to its own vehicle
+    // and each leg query is deterministic, so the result does not
+    // depend on the thread count.
     // ==========================================
-    void buildRoutes(vector<vector<int>>& assignedNodes) {
+    void buildRoutes(const vector<vector<int>>& assignedNodes) {
+        if (engine == RouteEngine::CCH && cch.needsCustomization(graph, alpha, beta))
+            cch.customize(graph, alpha, beta);
+
+        vector<int> order;
         for (size_t i = 0; i < vehicles.size(); ++i) {
             vehicles[i].assignedNodes = assignedNodes[i];
-            
-            if (assignedNodes[i].empty()) {
-                vehicles[i].route.clear();
-                continue;
-            }
+            vehicles[i].position = 0;
+            if (assignedNodes[i].empty()) { vehicles[i].route.clear(); vehicles[i].stopIndex.clear(); }
+            else order.push_back(i);
+        }
+        stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            return assignedNodes[a].size() > assignedNodes[b].size();
+        });
 
-            vector<int> fullRoute;
-            fullRoute.push_back(0);
+        unsigned threads = routeThreads ? routeThreads : max(1u, thread::hardware_concurrency());
+        ThreadPool pool(max<size_t>(1, min<size_t>(threads, order.size())));
+        while (extraWorkers.size() + 1 < pool.size())
+            extraWorkers.emplace_back(new RouteWorker(graph, landmarks, hierarchy, cch));
 
-            for (int nid : assignedNodes[i]) {
-                vector<int> path = graph.dijkstraMultiObjective(fullRoute.back(), nid);
-                if (path.empty()) continue;
-                path.erase(path.begin());
-                fullRoute.insert(fullRoute.end(), path.begin(), path.end());
-            }
+        pool.parallelFor(order.size(), [&](size_t k, unsigned t) {
+            int i = order[k];
+            buildRoute(worker(t), assignedNodes[i], vehicles[i].route, vehicles[i].stopIndex);
+        }, 1);
+        collectStats();
+    }
+
+    // ==========================================
+    // INCREMENTAL RE-PLAN
+    // Closes the (u, v) edges in `closed` while vehicles are en route.
+    // Only vehicles whose route past Vehicle::position uses a closed
+    // edge are touched, and only their legs that use one are searched
+    // again. The travelled prefix and intact legs are kept as they are.
+    // A broken leg is rerouted from the vehicle's position when it is
+    // on that leg, otherwise from the leg's start stop. A stop that can
+    // no longer be reached is dropped (stopIndex -1), and the next leg
+    // starts from wherever the vehicle is at that point.
+    // ==========================================
+    ReplanResult replanClosures(const vector<pair<int, int>>& closed) {
+        ReplanResult result;
+        vector<int> ids;
+        for (auto [u, v] : closed)
+            for (const Arc& a : graph.adj[u])
+                if (a.to == v) ids.push_back(a.edge);
+        unsigned before = graph.availabilityVersion;
+        if (graph.setEdgesAvailability(ids, false) == 0) return result;
+        if (depotTree.valid() && depotTreeVersion == before &&
+            depotTree.alpha == alpha && depotTree.beta == beta) {
+            result.treeNodesRepaired = depotTree.repair(graph, ids);
+        } else {
+            depotTree.build(graph, 0, alpha, beta);
+        }
+        depotTreeVersion = graph.availabilityVersion;
+        if (!stopCosts.empty()) result.matrixRowsRefreshed = stopCosts.refresh(graph, ids);
+        if (engine == RouteEngine::CCH && cch.needsCustomization(graph, alpha, beta))
+            cch.customize(graph, alpha, beta);
+
+        for (Vehicle& veh : vehicles) {
+            if (veh.route.empty() || !remainderBlocked(veh)) continue;
+            ++result.vehiclesAffected;
+            rerouteRemainder(veh, result);
+        }
+        collectStats();
+        return result;
+    }
+
+    // Some open edge still joins a and b
+    bool stepOpen(int a, int b) const {
+        for (int k = graph.csrOffset[a]; k < graph.csrOffset[a + 1]; ++k)
+            if (graph.csrTo[k] == b && graph.arcAvailable[k]) return true;
+        return false;
+    }
+
+    bool segmentOpen(const vector<int>& route, int from, int to) const {
+        for (int i = from; i < to; ++i)
+            if (!stepOpen(route[i], route[i + 1])) return false;
+        return true;
+    }
 
-            vector<int> returnPath = graph.dijkstraMultiObjective(fullRoute.back(), 0);
-            if (!returnPath.empty()) {
-                returnPath.erase(returnPath.begin());
-                fullRoute.insert(fullRoute.end(), returnPath.begin(), returnPath.end());
+    bool remainderBlocked(const Vehicle& veh) const {
+        int pos = min<int>(veh.position, veh.route.size() - 1);
+        return !segmentOpen(veh.route, pos, veh.route.size() - 1);
+    }
+
+    void rerouteRemainder(Vehicle& veh, ReplanResult& result) {
+        const vector<int>& route = veh.route;
+        int pos = min<int>(veh.position, route.size() - 1);
+        vector<int> out(route.begin(), route.begin() + pos + 1);
+
+        // Remaining legs: (assigned stop slot, route index of its end); -1 = return to depot
+        vector<pair<int, int>> legs;
+        for (size_t k = 0; k < veh.stopIndex.size(); ++k)
+            if (veh.stopIndex[k] > pos) legs.push_back({ (int)k, veh.stopIndex[k] });
+        legs.push_back({ -1, (int)route.size() - 1 });
+
+        int cursor = pos;
+        bool onRoute = true;        // out.back() == route[cursor]
+        for (auto [k, end] : legs) {
+            if (onRoute && segmentOpen(route, cursor, end)) {
+                out.insert(out.end(), route.begin() + cursor + 1, route.begin() + end + 1);
+            } else {
+                ++result.legsRerouted;
+                if (k == -1 && route[end] == depotTree.source) {
+                    vector<int> back = depotTree.pathTo(out.back());   // depot -> here
+                    if (back.empty()) break;            // depot cut off
+                    out.insert(out.end(), back.rbegin() + 1, back.rend());
+                } else if (!appendLeg(router, out.back(), route[end], out)) {
+                    if (k >= 0) {
+                        veh.stopIndex[k] = -1;
+                        ++result.stopsDropped;
+                        result.droppedStops.push_back(veh.assignedNodes[k]);
+                    }
+                    cursor = end;
+                    onRoute = false;
+                    continue;
+                }
             }
+            if (k >= 0) veh.stopIndex[k] = out.size() - 1;
+            cursor = end;
+            onRoute = true;
+        }
+        veh.route.swap(out);
+    }
 
-            vehicles[i].route = fullRoute;
+    RouteWorker& worker(unsigned t) { return t == 0 ? router : *extraWorkers[t - 1]; }
+
+    // Move the workers' counters into settledNodes / heapTotals / cch.stats
+    void collectStats() {
+        for (size_t t = 0; t <= extraWorkers.size(); ++t) {
+            RouteWorker& w = worker(t);
+            settledNodes += w.settled;
+            heapTotals += w.heapStats;
+            cch.stats.queries += w.cchSearch.queries;
+            cch.stats.queryMs += w.cchSearch.queryMs;
+            w.settled = 0;
+            w.heapStats = HeapStats();
+            w.cchSearch.queries = 0;
+            w.cchSearch.queryMs = 0.0;
         }
     }
 
@@ -134,21 +656,6 @@ struct DisasterManager {
     // Compute and Display Metrics
     // ==========================================
     void computeMetrics() {
-        double totalReliability = 0.0;
-        int totalEdges = 0;
-        int totalCombinedCost = 0;
-        int totalDelivered = 0;
-
-        double maxPriority = 0.0;
-        double maxDemand = 0.0;
-        for (const Node &n : graph.nodes) {
-            if (n.id != 0) {
-                maxPriority += n.priority;
-                maxDemand += n.demand;
-            }
-        }
-        double priorityScore = 0.0;
-
         for (auto &veh : vehicles) {
             if (veh.route.empty()) {
                 cout << "Vehicle " << veh.id << " Route: 0\n";
@@ -158,38 +665,12 @@ struct DisasterManager {
             }
 
             int delivered = 0;
+            for (size_t k = 0; k < veh.assignedNodes.size(); ++k)
+                if (veh.reaches(k)) delivered += graph.nodes[veh.assignedNodes[k]].demand;
             int cost = 0;
-            double vehReliabilitySum = 0.0;
-            int vehEdges = 0;
-
-            // Calculate cost and reliability from edges
-            for (size_t i = 0; i + 1 < veh.route.size(); ++i) {
-                int u = veh.route[i];
-                int v = veh.route[i + 1];
-
-                bool edgeFound = false;
-                for (auto &e : graph.adj[u]) {
-                    if (e.first == v && graph.isEdgeAvailable(u, v)) {
-                        cost += e.second;
-                        vehReliabilitySum += graph.getReliability(u, v);
-                        ++vehEdges;
-                        edgeFound = true;
-                        break;
-                    }
-                }
-                if (!edgeFound) continue;
-            }
-
-            // Count delivered demand ONLY from assigned nodes
-            for (int nid : veh.assignedNodes) {
-                delivered += graph.nodes[nid].demand;
-                priorityScore += graph.nodes[nid].priority;
-            }
-
-            totalDelivered += delivered;
-            totalCombinedCost += cost;
-            totalReliability += vehReliabilitySum;
-            totalEdges += vehEdges;
+            double relSum = 0.0;
+            int edgeCount = 0;
+            walkRoute(veh.route, cost, relSum, edgeCount);
 
             cout << "Vehicle " << veh.id << " Route: ";
             for (int n : veh.route) cout << n << " ";
@@ -204,27 +685,79 @@ struct DisasterManager {
             cout << "\nTotal Cost: " << cost << "\n\n";
         }
 
-        double avgReliability = totalEdges > 0 ? totalReliability / totalEdges : 0.0;
-        double prioritySatisfaction = maxPriority > 0.0 ? priorityScore / maxPriority : 0.0;
-        double demandSatisfaction = maxDemand > 0.0 ? totalDelivered / maxDemand : 0.0;
-
+        PlanMetrics m = measure();
         cout << "========================================\n";
         cout << "PERFORMANCE METRICS\n";
         cout << "========================================\n";
-        cout << "Total Combined Cost: " << totalCombinedCost << "\n";
-        cout << "Average Reliability: " << avgReliability << "\n";
-        cout << "Priority Satisfaction Score: " << prioritySatisfaction << "\n";
-        
-        int idleVehicles = count_if(vehicles.begin(), vehicles.end(),
+        cout << "Total Combined Cost: " << m.totalCost << "\n";
+        cout << "Average Reliability: " << m.avgReliability << "\n";
+        cout << "Priority Satisfaction Score: " << m.prioritySatisfaction << "\n";
+        cout << "Idle Vehicles: " << m.idleVehicles << " / " << vehicles.size() << "\n";
+        cout << "Overall Capacity Utilization: " << m.utilization << "%\n";
+        cout << "========================================\n";
+    }
+
+    // The summary figures of computeMetrics, without printing
+    PlanMetrics measure() const {
+        double totalReliability = 0.0;
+        int totalEdges = 0;
+        int totalCombinedCost = 0;
+        int totalDelivered = 0;
+
+        double maxPriority = 0.0;
+        for (const Node &n : graph.nodes)
+            if (n.id != 0) maxPriority += n.priority;
+        double priorityScore = 0.0;
+
+        for (const auto &veh : vehicles) {
+            if (veh.route.empty()) continue;
+
+            int cost = 0;
+            double vehReliabilitySum = 0.0;
+            int vehEdges = 0;
+            walkRoute(veh.route, cost, vehReliabilitySum, vehEdges);
+
+            // Count delivered demand ONLY from assigned nodes the route reaches
+            for (size_t k = 0; k < veh.assignedNodes.size(); ++k) {
+                if (!veh.reaches(k)) continue;
+                int nid = veh.assignedNodes[k];
+                totalDelivered += graph.nodes[nid].demand;
+                priorityScore += graph.nodes[nid].priority;
+            }
+
+            totalCombinedCost += cost;
+            totalReliability += vehReliabilitySum;
+            totalEdges += vehEdges;
+        }
+
+        PlanMetrics m;
+        m.totalCost = totalCombinedCost;
+        m.avgReliability = totalEdges > 0 ? totalReliability / totalEdges : 0.0;
+        m.prioritySatisfaction = maxPriority > 0.0 ? priorityScore / maxPriority : 0.0;
+        m.idleVehicles = count_if(vehicles.begin(), vehicles.end(),
             [](const Vehicle &v) { return v.route.empty(); });
-        cout << "Idle Vehicles: " << idleVehicles << " / " << vehicles.size() << "\n";
-        
+
         // Calculate total capacity utilization
         int totalCapacity = 0;
         for (const auto& v : vehicles) totalCapacity += v.capacity;
-        double overallUtilization = totalCapacity > 0 ? (100.0 * totalDelivered / totalCapacity) : 0.0;
-        cout << "Overall Capacity Utilization: " << overallUtilization << "%\n";
-        cout << "========================================\n";
+        m.utilization = totalCapacity > 0 ? (100.0 * totalDelivered / totalCapacity) : 0.0;
+        return m;
+    }
+
+    // Cost and reliability summed over the open edges of a route
+    void walkRoute(const vector<int>& route, int& cost, double& relSum, int& edgeCount) const {
+        for (size_t i = 0; i + 1 < route.size(); ++i) {
+            int u = route[i];
+            int v = route[i + 1];
+            for (int k = graph.csrOffset[u]; k < graph.csrOffset[u + 1]; ++k) {
+                if (graph.csrTo[k] == v && graph.arcAvailable[k]) {
+                    cost += graph.csrCost[k];
+                    relSum += graph.csrRel[k];
+                    ++edgeCount;
+                    break;
+                }
+            }
+        }
     }
 
     // ==========================================
@@ -0,0 +1,293 @@
+#ifndef DISTANCEMATRIX_H
+#define DISTANCEMATRIX_H
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <limits>
+#include <cstdio>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sys/types.h>
+#include "Graph.h"
+#include "DeltaStepping.h"
+
+using namespace std;
+
+// ==========================================
+// Stop x stop effective-cost table
+// One single-source search per stop, rows computed in parallel.
+// Storage is chosen from a memory budget:
+//   Full    - double per cell
+//   Compact - float per cell (half the memory)
+//   Spilled - float rows written to a temp file in tiles of rows,
+//             one tile resident at a time
+// refresh() brings the table up to date after edges are closed. With
+// trackClosures each row also remembers the edges on its shortest
+// paths (K x E bits, charged to the memory budget; skipped when that
+// would take more than half of it), and only the rows that used a
+// closed edge are recomputed. Without it every row is.
+// ==========================================
+struct DistanceMatrix {
+    enum Storage { Full, Compact, Spilled };
+
+    vector<int> stops;              // stop index -> node id
+    vector<int> index;              // node id -> stop index, -1 if not a stop
+    double alpha = 1.0, beta = 1.0;
+    Storage storage = Full;
+    bool deltaStepping = false;     // rows one at a time, each a parallel delta-stepping search
+    bool trackClosures = false;     // keep rowEdges for refresh()
+
+    vector<double> full;            // K*K cells when Full
+    vector<float> compact;          // K*K cells when Compact, resident tile when Spilled
+    vector<Bitset> rowEdges;        // row -> edge ids on its paths to the other stops, when tracked
+
+    FILE* spill = nullptr;
+    int tileRows = 0;               // rows per spilled tile
+    int residentTile = -1;
+    mutex tileLock;
+
+    DistanceMatrix() {}
+    DistanceMatrix(const DistanceMatrix&) = delete;
+    DistanceMatrix& operator=(const DistanceMatrix&) = delete;
+    ~DistanceMatrix() { clear(); }
+
+    int size() const { return stops.size(); }
+    bool empty() const { return stops.empty(); }
+    bool has(int node) const { return node >= 0 && node < (int)index.size() && index[node] != -1; }
+
+    void clear() {
+        if (spill) fclose(spill);
+        spill = nullptr;
+        stops.clear();
+        index.clear();
+        full.clear();
+        compact.clear();
+        rowEdges.clear();
+        residentTile = -1;
+    }
+
+    // Build the table over `stopNodes` (typically depot + demand nodes).
+    // memoryBudget is in bytes; threads = 0 uses every hardware thread.
+    void build(const Graph& graph, const vector<int>& stopNodes, double a, double b,
+               size_t memoryBudget = size_t(512) << 20, unsigned threads = 0) {
+        clear();
+        stops = stopNodes;
+        alpha = a;
+        beta = b;
+        index.assign(graph.N, -1);
+        for (int i = 0; i < (int)stops.size(); ++i) index[stops[i]] = i;
+
+        size_t K = stops.size();
+        size_t cells = K * K;
+        size_t trackBytes = K * ((graph.edges.size() + 63) / 64) * sizeof(uint64_t);
+        bool track = trackClosures && trackBytes <= memoryBudget / 2;
+        if (track) memoryBudget -= trackBytes;
+        if (cells * sizeof(double) <= memoryBudget) {
+            storage = Full;
+            full.resize(cells);
+            tileRows = K;
+        } else if (cells * sizeof(float) <= memoryBudget) {
+            storage = Compact;
+            compact.resize(cells);
+            tileRows = K;
+        } else {
+            storage = Spilled;
+            tileRows = max<size_t>(1, memoryBudget / (K * sizeof(float)));
+            compact.resize(size_t(tileRows) * K);
+            spill = tmpfile();
+            if (!spill) {
+                cerr << "Warning: no temp file for the stop table, keeping it in memory\n";
+                storage = Compact;
+                compact.resize(cells);
+                tileRows = K;
+            }
+        }
+
+        if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+        this->threads = threads;
+        if (track) rowEdges.resize(K);
+
+        for (size_t r0 = 0; r0 < K; r0 += tileRows) {
+            size_t r1 = min(K, r0 + tileRows);
+            vector<size_t> rows;
+            for (size_t r = r0; r < r1; ++r) rows.push_back(r);
+            computeRows(graph, rows, r0, threads);
+            if (storage == Spilled && !writeTile(r0 / tileRows)) {
+                keepInMemory(graph);
+                return;
+            }
+        }
+    }
+
+    bool tracking() const { return !rowEdges.empty(); }
+
+    // Recompute the rows whose paths use one of the `closed` edge ids,
+    // every row when not tracking. Other rows are still exact: closing
+    // edges only makes paths longer. Returns the rows recomputed.
+    int refresh(const Graph& graph, const vector<int>& closed) {
+        vector<size_t> stale;
+        for (size_t r = 0; r < stops.size(); ++r) {
+            if (!tracking()) { stale.push_back(r); continue; }
+            for (int id : closed)
+                if (rowEdges[r][id]) { stale.push_back(r); break; }
+        }
+        if (storage != Spilled) {
+            if (!stale.empty()) computeRows(graph, stale, 0, threads);
+            return stale.size();
+        }
+        for (size_t i = 0; i < stale.size();) {        // a tile at a time
+            int tile = stale[i] / tileRows;
+            vector<size_t> rows;
+            for (; i < stale.size() && int(stale[i] / tileRows) == tile; ++i) rows.push_back(stale[i]);
+            if (tile != residentTile) loadTile(tile);
+            computeRows(graph, rows, size_t(tile) * tileRows, threads);
+            if (!writeTile(tile)) {
+                keepInMemory(graph);
+                return stops.size();
+            }
+        }
+        return stale.size();
+    }
+
+    // Effective cost between two stop nodes; numeric_limits<double>::max() if unreachable
+    double cost(int from, int to) {
+        size_t K = stops.size();
+        size_t i = index[from], j = index[to];
+        if (storage == Full) return full[i * K + j];
+
+        float c;
+        if (storage == Compact) {
+            c = compact[i * K + j];
+        } else {
+            lock_guard<mutex> lock(tileLock);      // routing threads share the resident tile
+            int tile = i / tileRows;
+            if (tile != residentTile) loadTile(tile);
+            c = compact[(i - size_t(tile) * tileRows) * K + j];
+        }
+        return c == numeric_limits<float>::infinity() ? numeric_limits<double>::max() : c;
+    }
+
+    bool reachable(int from, int to) { return cost(from, to) != numeric_limits<double>::max(); }
+
+private:
+    unsigned threads = 1;
+
+    // `rows` into full, or into the compact buffer (relative to tile start r0 when spilled)
+    void computeRows(const Graph& graph, const vector<size_t>& rows, size_t r0, unsigned threads) {
+        size_t K = stops.size();
+        auto store = [&](size_t r, const vector<double>& row) {
+            size_t base = (storage == Spilled ? r - r0 : r) * K;
+            for (size_t j = 0; j < K; ++j) {
+                if (storage == Full)
+                    full[base + j] = row[j];
+                else
+                    compact[base + j] = row[j] == numeric_limits<double>::max()
+                        ? numeric_limits<float>::infinity() : float(row[j]);
+            }
+        };
+
+        if (deltaStepping) {
+            ThreadPool pool(threads);
+            DeltaStepping ds(graph, pool);
+            vector<double> row(K);
+            for (size_t r : rows) {
+                ds.run(stops[r], alpha, beta);
+                for (size_t j = 0; j < K; ++j) row[j] = ds.dist[stops[j]];
+                store(r, row);
+                if (tracking()) markPaths(graph, r, ds.dist, ds.parent);
+            }
+            return;
+        }
+
+        atomic<size_t> next(0);
+        auto worker = [&]() {
+            DijkstraWorkspace ws;
+            for (size_t i = next++; i < rows.size(); i = next++) {
+                size_t r = rows[i];
+                store(r, graph.dijkstraOneToMany(ws, stops[r], stops, alpha, beta));
+                if (tracking()) markPaths(graph, r, ws.dist, ws.parent, &ws);
+            }
+        };
+
+        unsigned n = min<size_t>(threads, rows.size());
+        if (n <= 1) { worker(); return; }
+        vector<thread> pool;
+        for (unsigned t = 0; t < n; ++t) pool.emplace_back(worker);
+        for (auto& t : pool) t.join();
+    }
+
+    // Edges on the tree paths from row r's source to every reachable stop.
+    // Each stop is walked up until a node already on a path. ws, when
+    // given, says which dist / parent entries belong to the last search.
+    void markPaths(const Graph& graph, size_t r, const vector<double>& dist, const vector<int>& parent,
+                   const DijkstraWorkspace* ws = nullptr) {
+        Bitset& used = rowEdges[r];
+        used.assign(graph.edges.size(), false);
+        Bitset on;
+        on.assign(graph.N, false);
+        on.set(stops[r]);
+        for (int t : stops) {
+            if (ws ? !ws->touched(t) : parent[t] == -1) continue;
+            for (int v = t; !on[v]; v = parent[v]) {
+                on.set(v);
+                int p = parent[v];
+                for (int k = graph.csrOffset[p]; k < graph.csrOffset[p + 1]; ++k) {   // the arc that set dist[v]
+                    if (graph.csrTo[k] != v || !graph.arcAvailable[k]) continue;
+                    double w = alpha * graph.csrCost[k] + beta * (1.0 - graph.csrRel[k]);
+                    if (abs(dist[p] + w - dist[v]) < 1e-6) { used.set(graph.csrEdge[k]); break; }
+                }
+            }
+        }
+    }
+
+    // 64-bit offsets: the file passes 2 GB in exactly the case it exists for
+    bool seekTile(int tile) {
+        size_t offset = size_t(tile) * tileRows * stops.size() * sizeof(float);
+#ifdef _WIN32
+        return _fseeki64(spill, (long long)offset, SEEK_SET) == 0;
+#else
+        return fseeko(spill, (off_t)offset, SEEK_SET) == 0;
+#endif
+    }
+
+    size_t tileCells(int tile) const {
+        size_t K = stops.size();
+        return min(K - size_t(tile) * tileRows, size_t(tileRows)) * K;
+    }
+
+    bool writeTile(int tile) {
+        residentTile = tile;
+        size_t cells = tileCells(tile);
+        return seekTile(tile) && fwrite(compact.data(), sizeof(float), cells, spill) == cells;
+    }
+
+    // A tile the table wrote itself must read back whole; nothing sensible
+    // can be returned for its cells if it does not
+    void loadTile(int tile) {
+        size_t cells = tileCells(tile);
+        if (!seekTile(tile) || fread(compact.data(), sizeof(float), cells, spill) != cells) {
+            cerr << "ERROR: stop table spill file unreadable (tile " << tile << ")\n";
+            abort();
+        }
+        residentTile = tile;
+    }
+
+    // Spill file failed while writing: recompute the whole table as Compact
+    void keepInMemory(const Graph& graph) {
+        cerr << "Warning: writing the stop table spill file failed, keeping it in memory\n";
+        fclose(spill);
+        spill = nullptr;
+        storage = Compact;
+        tileRows = stops.size();
+        residentTile = -1;
+        compact.assign(stops.size() * stops.size(), 0.0f);
+        vector<size_t> rows(stops.size());
+        for (size_t r = 0; r < rows.size(); ++r) rows[r] = r;
+        computeRows(graph, rows, 0, threads);
+    }
+};
+
+#endif
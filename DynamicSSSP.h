@@ -0,0 +1,168 @@
+#pragma once
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include "Graph.h"
+
+using namespace std;
+
+// ==========================================
+// Shortest-path tree kept current across edge closures
+// build() runs one full Dijkstra from `source`. After that, repair()
+// takes the edges closed since the last build or repair, and fixes up
+// only the nodes whose tree path used one of them (Ramalingam-Reps,
+// decremental case):
+//   1. affected = subtrees hanging off closed tree edges. Every other
+//      node keeps its path, and closing edges cannot make it shorter.
+//   2. each affected node is seeded from its open arcs to unaffected
+//      neighbours, then a Dijkstra restricted to the affected set
+//      settles them.
+// The work is proportional to the affected subtrees and their arcs,
+// not to the graph. Reopened edges or changed reliabilities can make
+// paths shorter, which a decremental repair does not handle: repair()
+// rebuilds when the graph's weights changed, and callers rebuild
+// after reopening edges.
+// ==========================================
+struct ShortestPathTree {
+    int source = -1;
+    double alpha = 1.0, beta = 1.0;
+    vector<double> dist;            // effective cost, numeric_limits<double>::max() if unreachable
+    vector<double> pathReli;        // reliability product of the tree path (tie-break)
+    vector<int> parent;             // -1 at the source and unreachable nodes
+
+    int repairs = 0;
+    int lastAffected = 0;           // nodes re-settled by the last repair
+    long long totalAffected = 0;
+
+    bool valid() const { return source != -1; }
+
+    void build(const Graph& graph, int s, double a, double b) {
+        source = s;
+        alpha = a;
+        beta = b;
+        builtWeights = graph.weightVersion;
+        graph.dijkstraSearch(ws, s, s, a, b, false);
+        dist.resize(graph.N);
+        pathReli.resize(graph.N);
+        parent.resize(graph.N);
+        for (int v = 0; v < graph.N; ++v) {
+            dist[v] = ws.getDist(v);
+            pathReli[v] = ws.touched(v) ? ws.pathReli[v] : 0.0;
+            parent[v] = ws.touched(v) ? ws.parent[v] : -1;
+        }
+        mark.assign(graph.N, 0);
+        generation = 0;
+    }
+
+    // `closed` are the ids of edges made unavailable since the last
+    // build / repair. Returns the number of nodes re-settled.
+    int repair(const Graph& graph, const vector<int>& closed) {
+        if (graph.weightVersion != builtWeights) {
+            build(graph, source, alpha, beta);
+            lastAffected = graph.N;
+            totalAffected += graph.N;
+            ++repairs;
+            return graph.N;
+        }
+        if (++generation == 0) {            // wrapped: clear marks once
+            fill(mark.begin(), mark.end(), 0);
+            generation = 1;
+        }
+
+        // 1. Roots: children whose tree edge to the parent is gone
+        affected.clear();
+        for (int id : closed) {
+            const Edge& e = graph.edges[id];
+            if (parent[e.v] == e.u && !treeStepOpen(graph, e.u, e.v)) addAffected(e.v);
+            if (parent[e.u] == e.v && !treeStepOpen(graph, e.v, e.u)) addAffected(e.u);
+        }
+        // Subtrees below them, breadth first through the parent links
+        for (size_t i = 0; i < affected.size(); ++i) {
+            int u = affected[i];
+            for (int k = graph.csrOffset[u]; k < graph.csrOffset[u + 1]; ++k) {
+                int w = graph.csrTo[k];
+                if (parent[w] == u && mark[w] != generation) addAffected(w);
+            }
+        }
+        for (int v : affected) {
+            dist[v] = numeric_limits<double>::max();
+            pathReli[v] = 0.0;
+            parent[v] = -1;
+        }
+
+        // 2. Seed from the unaffected boundary (the graph is undirected,
+        //    so v's arcs are also its in-arcs), then settle the affected set
+        heap.reset(graph.N);
+        for (int v : affected) {
+            for (int k = graph.csrOffset[v]; k < graph.csrOffset[v + 1]; ++k) {
+                int u = graph.csrTo[k];
+                if (mark[u] == generation || dist[u] == numeric_limits<double>::max()) continue;
+                relax(graph, u, v, k);
+            }
+            if (parent[v] != -1) heap.push({ dist[v], v, pathReli[v] });
+        }
+        while (!heap.empty()) {
+            SearchState top = heap.pop();
+            int u = top.u;
+            if (top.effCost > dist[u]) continue;
+            for (int k = graph.csrOffset[u]; k < graph.csrOffset[u + 1]; ++k) {
+                int v = graph.csrTo[k];
+                if (mark[v] == generation && relax(graph, u, v, k))
+                    heap.push({ dist[v], v, pathReli[v] });
+            }
+        }
+
+        lastAffected = affected.size();
+        totalAffected += affected.size();
+        ++repairs;
+        return affected.size();
+    }
+
+    // Tree path source -> v; empty if v is unreachable
+    vector<int> pathTo(int v) const {
+        vector<int> path;
+        if (dist[v] == numeric_limits<double>::max()) return path;
+        for (; v != -1; v = parent[v]) path.push_back(v);
+        reverse(path.begin(), path.end());
+        return path;
+    }
+
+private:
+    DijkstraWorkspace ws;
+    BinaryHeap heap;
+    vector<unsigned> mark;          // node -> generation it was affected in
+    unsigned generation = 0;
+    vector<int> affected;
+    unsigned builtWeights = 0;
+
+    void addAffected(int v) {
+        mark[v] = generation;
+        affected.push_back(v);
+    }
+
+    // Same relaxation rule as Graph::runDijkstra, arc k = u -> v
+    bool relax(const Graph& graph, int u, int v, int k) {
+        if (!graph.arcAvailable[k]) return false;
+        double edgeRel = graph.csrRel[k];
+        double nd = dist[u] + alpha * graph.csrCost[k] + beta * (1.0 - edgeRel);
+        double rel = pathReli[u] * edgeRel;
+        if (nd < dist[v] || (abs(nd - dist[v]) < 1e-6 && rel > pathReli[v])) {
+            dist[v] = min(dist[v], nd);
+            parent[v] = u;
+            pathReli[v] = rel;
+            return true;
+        }
+        return false;
+    }
+
+    // An open arc p -> v still carries v's tree distance (parallel edges)
+    bool treeStepOpen(const Graph& graph, int p, int v) const {
+        for (int k = graph.csrOffset[p]; k < graph.csrOffset[p + 1]; ++k) {
+            if (graph.csrTo[k] != v || !graph.arcAvailable[k]) continue;
+            double w = alpha * graph.csrCost[k] + beta * (1.0 - graph.csrRel[k]);
+            if (abs(dist[p] + w - dist[v]) < 1e-6) return true;
+        }
+        return false;
+    }
+};
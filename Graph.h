@@ -3,109 +3,282 @@
 #include <queue>
 #include <limits>
 #include <cmath>
+#include <cassert>
 #include "node.h"
 #include "edge.h"
+#include "workspace.h"
+#include "Bitset.h"
 
 using namespace std;
 
 struct Graph {
     int N; // number of nodes
     vector<Node> nodes;
-    vector<vector<pair<int, int>>> adj;        // node -> [(neighbor, cost)]
-    vector<vector<double>> reliability;       // node -> neighbor reliability
-    vector<vector<bool>> edgeAvailable;       // dynamic availability
+    vector<Edge> edges;                        // edge id -> (u, v, cost, reliability)
+    vector<vector<Arc>> adj;                   // node -> [(neighbor, cost, reliability, edge id)]
+    Bitset edgeAvailable;                      // edge id -> dynamic availability
+    unsigned availabilityVersion = 0;          // bumped on every availability change
+    unsigned weightVersion = 0;                // bumped on every reliability change
+
+    // Frozen CSR copy of adj used by the query paths; rebuilt by freeze()
+    bool frozen = false;
+    vector<int> csrOffset;                     // node -> first arc, size N + 1
+    vector<int> csrTo;                         // arc -> neighbor
+    vector<int> csrCost;                       // arc -> cost
+    vector<double> csrRel;                     // arc -> reliability
+    vector<int> csrEdge;                       // arc -> edge id
+    vector<double> csrNegLogRel;               // arc -> -log(reliability), for max-product search
+    Bitset arcAvailable;                       // arc -> availability of its edge, tested by the searches
+    vector<int> edgeArcs;                      // edge id -> its two arcs, at 2 * id and 2 * id + 1
+    int maxCost = 0;                           // largest edge cost
 
     Graph(int n) : N(n) {
         adj.resize(N);
-        reliability.resize(N, vector<double>(N, 1.0));
-        edgeAvailable.resize(N, vector<bool>(N, true)); // all edges initially available
     }
 
     void addEdge(int u, int v, int cost, double rel) {
-        adj[u].push_back({ v, cost });
-        adj[v].push_back({ u, cost });   // undirected
-        reliability[u][v] = rel;
-        reliability[v][u] = rel;
-        edgeAvailable[u][v] = true;
-        edgeAvailable[v][u] = true;
+        int id = edges.size();
+        edges.push_back({ u, v, cost, rel });
+        edgeAvailable.push_back(true);     // all edges initially available
+        adj[u].push_back({ v, cost, rel, id });
+        adj[v].push_back({ u, cost, rel, id });   // undirected
+        frozen = false;
+    }
+
+    // Pack adj into contiguous CSR arrays. Call once after loading;
+    // the searches below walk these arrays instead of adj.
+    void freeze() {
+        csrOffset.assign(N + 1, 0);
+        for (int u = 0; u < N; ++u)
+            csrOffset[u + 1] = csrOffset[u] + adj[u].size();
+
+        int M = csrOffset[N];
+        csrTo.resize(M);
+        csrCost.resize(M);
+        csrRel.resize(M);
+        csrEdge.resize(M);
+        csrNegLogRel.resize(M);
+        arcAvailable.assign(M, true);
+        edgeArcs.assign(2 * edges.size(), -1);
+        maxCost = 0;
+        for (int u = 0; u < N; ++u) {
+            int k = csrOffset[u];
+            for (const Arc& a : adj[u]) {
+                int slot = 2 * a.edge;
+                edgeArcs[edgeArcs[slot] == -1 ? slot : slot + 1] = k;
+                arcAvailable.set(k, edgeAvailable[a.edge]);
+                csrTo[k] = a.to;
+                csrCost[k] = a.cost;
+                csrRel[k] = a.reliability;
+                csrEdge[k] = a.edge;
+                csrNegLogRel[k] = -log(a.reliability);
+                maxCost = max(maxCost, a.cost);
+                ++k;
+            }
+        }
+        frozen = true;
+    }
+
+    // Edge id joining u and v, or -1 if there is none
+    int findEdge(int u, int v) const {
+        for (const Arc& a : adj[u])
+            if (a.to == v) return a.edge;
+        return -1;
     }
 
     void setEdgeAvailability(int u, int v, bool avail) {
-        edgeAvailable[u][v] = avail;
-        edgeAvailable[v][u] = avail;   // undirected
+        for (const Arc& a : adj[u])
+            if (a.to == v) setAvailable(a.edge, avail);   // shared by both directions
+        ++availabilityVersion;
+    }
+
+    // Bulk form: every listed edge id in one call and one version bump.
+    // Returns how many edges changed state.
+    int setEdgesAvailability(const vector<int>& ids, bool avail) {
+        int changed = 0;
+        for (int id : ids) {
+            if (edgeAvailable[id] == avail) continue;
+            setAvailable(id, avail);
+            ++changed;
+        }
+        if (changed) ++availabilityVersion;
+        return changed;
+    }
+
+    // Close (or reopen) every edge with both ends in `region`, e.g. a flooded
+    // district; with `touching`, also the edges leaving it. Costs the total
+    // degree of the region. Returns how many edges changed state.
+    int setRegionAvailability(const vector<int>& region, bool avail, bool touching = false) {
+        Bitset inside;
+        inside.assign(N, false);
+        for (int u : region) inside.set(u);
+
+        int changed = 0;
+        for (int u : region) {
+            for (const Arc& a : adj[u]) {
+                if (!touching && !inside[a.to]) continue;
+                if (edgeAvailable[a.edge] == avail) continue;
+                setAvailable(a.edge, avail);
+                ++changed;
+            }
+        }
+        if (changed) ++availabilityVersion;
+        return changed;
+    }
+
+    int closeRegion(const vector<int>& region, bool touching = false) {
+        return setRegionAvailability(region, false, touching);
+    }
+
+    // Update the reliability of every u - v edge in all copies (edges, adj, CSR)
+    void setEdgeReliability(int u, int v, double rel) {
+        for (Arc& a : adj[u]) {
+            if (a.to != v) continue;
+            a.reliability = rel;
+            edges[a.edge].reliability = rel;
+        }
+        for (Arc& a : adj[v])
+            if (a.to == u) a.reliability = rel;
+        if (frozen) {
+            for (int k = csrOffset[u]; k < csrOffset[u + 1]; ++k)
+                if (csrTo[k] == v) { csrRel[k] = rel; csrNegLogRel[k] = -log(rel); }
+            for (int k = csrOffset[v]; k < csrOffset[v + 1]; ++k)
+                if (csrTo[k] == u) { csrRel[k] = rel; csrNegLogRel[k] = -log(rel); }
+        }
+        ++weightVersion;
     }
 
     bool isEdgeAvailable(int u, int v) const {
-        return edgeAvailable[u][v];
+        int id = findEdge(u, v);
+        return id == -1 || edgeAvailable[id];
     }
 
     double getReliability(int u, int v) const {
-        return reliability[u][v];
+        int id = findEdge(u, v);
+        return id == -1 ? 1.0 : edges[id].reliability;
     }
 
     // Dijkstra with multi-objective: alpha = weight for cost, beta = weight for unreliability
+    // Requires freeze() to have been called after the last addEdge.
     vector<int> dijkstraMultiObjective(int start, int end, double alpha = 1.0, double beta = 1.0) const {
-        struct State {
-            double effCost;
-            int u;
-            double relSum;
-            bool operator>(const State& other) const {
-                if (effCost != other.effCost) return effCost > other.effCost;
-                return relSum < other.relSum;
-            }
-        };
+        DijkstraWorkspace ws;
+        return dijkstraMultiObjective(ws, start, end, alpha, beta);
+    }
 
-        struct CompareState {
-            bool operator()(const State& a, const State& b) const {
-                if (a.effCost != b.effCost) return a.effCost > b.effCost;
-                return a.relSum < b.relSum;
-            }
-        };
+    // Same search, reusing the caller's workspace instead of allocating per query
+    vector<int> dijkstraMultiObjective(DijkstraWorkspace& ws, int start, int end,
+                                       double alpha = 1.0, double beta = 1.0,
+                                       bool stopAtTarget = true) const {
+        vector<int> path;
+        if (!dijkstraSearch(ws, start, end, alpha, beta, stopAtTarget)) return path;
 
-        vector<double> dist(N, numeric_limits<double>::max());
-        vector<int> parent(N, -1);
-        vector<double> pathReli(N, 0.0);
-        dist[start] = 0;
-        pathReli[start] = 1.0;
+        path.push_back(start);
+        ws.appendPath(end, path);
+        return path;
+    }
 
-        priority_queue<State, vector<State>, CompareState> pq;
-        pq.push({ 0.0, start, 1.0 });
+    // Point-to-point search: fills ws.dist / ws.parent and returns whether `end` is
+    // reachable. With stopAtTarget the search ends as soon as `end` is settled;
+    // otherwise the whole reachable graph is settled. ws.settled reports the work done.
+    bool dijkstraSearch(DijkstraWorkspace& ws, int start, int end,
+                        double alpha = 1.0, double beta = 1.0,
+                        bool stopAtTarget = true) const {
+        return dijkstraSearchWith(ws, ws.heap, start, end, alpha, beta, stopAtTarget);
+    }
+
+    // Same query with a caller-chosen heap (see Heaps.h); heap.stats holds
+    // the pushes / pops / stale pops of this query afterwards. A separate
+    // name, so integer weights in a plain call never deduce Heap = int.
+    template <class Heap>
+    bool dijkstraSearchWith(DijkstraWorkspace& ws, Heap& heap, int start, int end,
+                        double alpha = 1.0, double beta = 1.0,
+                        bool stopAtTarget = true) const {
+        ws.reset(N);
+        heap.reset(N);
+        runDijkstra(ws, heap, start, alpha, beta, [&](int u) { return stopAtTarget && u == end; });
+        return ws.getDist(end) != numeric_limits<double>::max();
+    }
+
+    // One-to-many search: settles from `start` until every target is settled
+    // (or the reachable graph is exhausted). Returns the effective cost to each
+    // target, numeric_limits<double>::max() if unreachable; paths are read back
+    // with ws.appendPath(target, out) until the workspace is reused.
+    vector<double> dijkstraOneToMany(DijkstraWorkspace& ws, int start, const vector<int>& targets,
+                                     double alpha = 1.0, double beta = 1.0) const {
+        ws.reset(N);
+        int pending = 0;
+        for (int t : targets) {
+            if (ws.targetMark[t] == ws.generation) continue;
+            ws.targetMark[t] = ws.generation;
+            ++pending;
+        }
 
-        while (!pq.empty()) {
-            State top = pq.top(); pq.pop();
+        if (pending > 0) {
+            runDijkstra(ws, ws.heap, start, alpha, beta, [&](int u) {
+                if (ws.targetMark[u] != ws.generation) return false;
+                ws.targetMark[u] = 0;   // count each target once
+                return --pending == 0;
+            });
+        }
+
+        vector<double> cost;
+        cost.reserve(targets.size());
+        for (int t : targets) cost.push_back(ws.getDist(t));
+        return cost;
+    }
+
+    // Search core shared by the queries above. The caller resets ws and heap; stop(u) is
+    // asked after each node is settled and ends the search when it returns true.
+    template <class Heap, class StopFn>
+    void runDijkstra(DijkstraWorkspace& ws, Heap& heap, int start, double alpha, double beta, StopFn stop) const {
+        assert(frozen && "Graph::freeze() must run after the last addEdge");
+        ws.touch(start);
+        ws.dist[start] = 0;
+        ws.pathReli[start] = 1.0;
+        heap.push({ 0.0, start, 1.0 });
+
+        while (!heap.empty()) {
+            SearchState top = heap.pop();
             int u = top.u;
             double d = top.effCost;
             double relSum = top.relSum;
 
-            if (d > dist[u]) continue;
+            if (d > ws.dist[u]) { ++heap.stats.stalePops; continue; }
+            ++ws.settled;
+            if (stop(u)) break;
 
-            for (auto& edge : adj[u]) {
-                int v = edge.first;
-                double c = edge.second;
+            for (int k = csrOffset[u]; k < csrOffset[u + 1]; ++k) {
+                int v = csrTo[k];
+                double c = csrCost[k];
 
-                if (!isEdgeAvailable(u, v)) continue;
+                if (!arcAvailable[k]) continue;
 
-                double edgeRel = reliability[u][v];
+                double edgeRel = csrRel[k];
                 double effCost = alpha * c + beta * (1.0 - edgeRel);
                 double newRelSum = relSum * edgeRel;
 
-                if (dist[u] + effCost < dist[v] ||
-                    (abs(dist[u] + effCost - dist[v]) < 1e-6 && newRelSum > pathReli[v])) {
-                    dist[v] = dist[u] + effCost;
-                    parent[v] = u;
-                    pathReli[v] = newRelSum;
-                    pq.push({ dist[v], v, newRelSum });
+                // Costs within 1e-6 count as a tie decided by reliability. A tie
+                // never raises dist[v]: with zero-weight edges (alpha = 0,
+                // reliability 1) that could otherwise form a parent cycle.
+                ws.touch(v);
+                double nd = ws.dist[u] + effCost;
+                if (nd < ws.dist[v] ||
+                    (abs(nd - ws.dist[v]) < 1e-6 && newRelSum > ws.pathReli[v])) {
+                    ws.dist[v] = min(ws.dist[v], nd);
+                    ws.parent[v] = u;
+                    ws.pathReli[v] = newRelSum;
+                    heap.push({ ws.dist[v], v, newRelSum });
                 }
             }
         }
+    }
 
-        vector<int> path;
-        if (dist[end] == numeric_limits<double>::max()) return path;
-
-        // reconstruct path from end -> start
-        for (int v = end; v != -1; v = parent[v])
-            path.insert(path.begin(), v);
-
-        return path;
+private:
+    // Edge bit plus the CSR bits of both its arcs
+    void setAvailable(int id, bool avail) {
+        edgeAvailable.set(id, avail);
+        if (!frozen) return;
+        arcAvailable.set(edgeArcs[2 * id], avail);
+        arcAvailable.set(edgeArcs[2 * id + 1], avail);
     }
 };
@@ -0,0 +1,207 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+// Heap entry for the multi-objective searches
+struct SearchState {
+    double effCost;
+    int u;
+    double relSum;
+};
+
+// Min effective cost first; on ties prefer the more reliable path
+struct CompareState {
+    bool operator()(const SearchState& a, const SearchState& b) const {
+        if (a.effCost != b.effCost) return a.effCost > b.effCost;
+        return a.relSum < b.relSum;
+    }
+};
+
+// Per-query heap counters
+struct HeapStats {
+    long long pushes = 0;
+    long long pops = 0;
+    long long stalePops = 0;        // popped entries superseded by a later push
+    long long decreaseKeys = 0;     // pushes that updated an entry in place
+
+    HeapStats& operator+=(const HeapStats& o) {
+        pushes += o.pushes;
+        pops += o.pops;
+        stalePops += o.stalePops;
+        decreaseKeys += o.decreaseKeys;
+        return *this;
+    }
+};
+
+// Every heap below offers reset(n), empty(), push(state) and pop(), so the
+// searches can take the heap as a template parameter.
+
+// ==========================================
+// Binary heap with lazy deletion: an improved label is pushed again and
+// the old entry is skipped as stale when popped
+// ==========================================
+struct BinaryHeap {
+    vector<SearchState> data;
+    HeapStats stats;
+
+    void reset(int) { data.clear(); stats = HeapStats(); }
+    bool empty() const { return data.empty(); }
+    const SearchState& front() const { return data.front(); }
+
+    void push(const SearchState& s) {
+        ++stats.pushes;
+        data.push_back(s);
+        push_heap(data.begin(), data.end(), CompareState());
+    }
+
+    SearchState pop() {
+        ++stats.pops;
+        pop_heap(data.begin(), data.end(), CompareState());
+        SearchState s = data.back();
+        data.pop_back();
+        return s;
+    }
+};
+
+// ==========================================
+// Indexed 4-ary heap with decrease-key: at most one entry per node, so
+// no stale pops, and a shallower tree than the binary heap
+// ==========================================
+struct QuaternaryHeap {
+    vector<SearchState> data;
+    vector<int> pos;                // node -> index in data (valid when stamped)
+    vector<unsigned> posStamp;
+    unsigned generation = 0;
+    HeapStats stats;
+
+    void reset(int n) {
+        if ((int)pos.size() != n) {
+            pos.resize(n);
+            posStamp.assign(n, 0);
+            generation = 0;
+        }
+        if (++generation == 0) {
+            fill(posStamp.begin(), posStamp.end(), 0);
+            generation = 1;
+        }
+        data.clear();
+        stats = HeapStats();
+    }
+
+    bool empty() const { return data.empty(); }
+    const SearchState& front() const { return data.front(); }
+
+    // Insert, or decrease the key of the node's existing entry
+    void push(const SearchState& s) {
+        ++stats.pushes;
+        int i = posStamp[s.u] == generation ? pos[s.u] : -1;
+        if (i == -1) {
+            data.push_back(s);
+            place(data.size() - 1);
+            siftUp(data.size() - 1);
+        } else if (before(s, data[i])) {
+            ++stats.decreaseKeys;
+            data[i] = s;
+            siftUp(i);
+        }
+    }
+
+    SearchState pop() {
+        ++stats.pops;
+        SearchState top = data[0];
+        pos[top.u] = -1;
+        data[0] = data.back();
+        data.pop_back();
+        if (!data.empty()) {
+            place(0);
+            siftDown(0);
+        }
+        return top;
+    }
+
+private:
+    static bool before(const SearchState& a, const SearchState& b) { return CompareState()(b, a); }
+
+    void place(size_t i) {
+        pos[data[i].u] = i;
+        posStamp[data[i].u] = generation;
+    }
+
+    void siftUp(size_t i) {
+        while (i > 0) {
+            size_t p = (i - 1) / 4;
+            if (!before(data[i], data[p])) break;
+            swap(data[i], data[p]);
+            place(i);
+            place(p);
+            i = p;
+        }
+    }
+
+    void siftDown(size_t i) {
+        while (true) {
+            size_t best = i, c = 4 * i + 1;
+            for (size_t k = c; k < c + 4 && k < data.size(); ++k)
+                if (before(data[k], data[best])) best = k;
+            if (best == i) break;
+            swap(data[i], data[best]);
+            place(i);
+            place(best);
+            i = best;
+        }
+    }
+};
+
+// ==========================================
+// Radix heap for monotone integer keys (beta = 0 with an integral
+// alpha, so every effective cost is a whole number). Bucket b holds keys
+// whose highest bit differing from the last popped key is b - 1; pushes
+// are O(1) and each entry moves down at most 64 times. Lazy deletion as
+// in BinaryHeap; equal keys pop in LIFO order.
+// ==========================================
+struct RadixHeap {
+    vector<SearchState> buckets[65];
+    uint64_t last = 0;
+    size_t count = 0;
+    HeapStats stats;
+
+    void reset(int) {
+        for (auto& b : buckets) b.clear();
+        last = 0;
+        count = 0;
+        stats = HeapStats();
+    }
+
+    bool empty() const { return count == 0; }
+
+    void push(const SearchState& s) {
+        ++stats.pushes;
+        buckets[bucketOf(key(s))].push_back(s);
+        ++count;
+    }
+
+    SearchState pop() {
+        ++stats.pops;
+        if (buckets[0].empty()) {
+            int i = 1;
+            while (buckets[i].empty()) ++i;
+            uint64_t minKey = key(buckets[i][0]);
+            for (const SearchState& s : buckets[i]) minKey = min(minKey, key(s));
+            last = minKey;
+            for (const SearchState& s : buckets[i]) buckets[bucketOf(key(s))].push_back(s);
+            buckets[i].clear();
+        }
+        SearchState s = buckets[0].back();
+        buckets[0].pop_back();
+        --count;
+        return s;
+    }
+
+private:
+    static uint64_t key(const SearchState& s) { return (uint64_t)s.effCost; }
+
+    int bucketOf(uint64_t k) const { return k == last ? 0 : 64 - __builtin_clzll(k ^ last); }
+};
@@ -0,0 +1,172 @@
+#ifndef PARETO_H
+#define PARETO_H
+
+#include <vector>
+#include <queue>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include "Graph.h"
+
+using namespace std;
+
+// One non-dominated start -> end route
+struct ParetoRoute {
+    long long cost;                 // summed edge cost
+    double reliability;             // product of edge reliabilities
+    vector<int> path;               // start ... end
+};
+
+// ==========================================
+// Bi-criteria label-setting router (cost, reliability product)
+// Returns the Pareto frontier: every route for which no other route is
+// both cheaper and more reliable. Reliability is handled as the sum of
+// -log(rel), so both criteria are minimised additively.
+// Labels are settled in lexicographic order of (cost, -log rel), each
+// offset by exact lower bounds to the target from two reverse searches.
+// A label survives only if its -log rel beats every label already
+// settled at its node and at the target. Both checks are O(1), so no
+// per-node label bags are needed.
+// Two limits trade frontier points for work:
+//   maxRoutes  - stop once the target has settled this many routes.
+//                Target labels settle in cost order, so these are the
+//                maxRoutes cheapest frontier routes, and the labels
+//                settled are a prefix of the exact search's: never
+//                more work than the exact search
+//   relEpsilon - a label must improve -log rel by more than this, so
+//                kept reliabilities differ by a factor of at least
+//                exp(relEpsilon); close frontier points may be dropped
+// The routes that are returned are real paths, sorted by cost.
+// ==========================================
+struct ParetoRouter {
+    const Graph& graph;
+    int maxRoutes = 0;              // 0 = the whole frontier
+    double relEpsilon = 1e-12;
+    long long labelsCreated = 0;    // last query
+    long long labelsSettled = 0;
+
+    ParetoRouter(const Graph& g) : graph(g) {}
+
+    vector<ParetoRoute> search(int start, int end) {
+        vector<ParetoRoute> front;
+        labelsCreated = labelsSettled = 0;
+        int N = graph.N;
+
+        lowerBounds(end, costBound, relBound);
+        if (costBound[start] == numeric_limits<double>::max()) return front;
+
+        const double INF = numeric_limits<double>::max();
+        bestRel.assign(N, INF);
+        labels.clear();
+        priority_queue<Entry, vector<Entry>, greater<Entry>> open;
+
+        labels.push_back({ start, -1, 0, 0.0 });
+        open.push({ (long long)costBound[start], relBound[start], 0 });
+        ++labelsCreated;
+
+        while (!open.empty()) {
+            Entry top = open.top();
+            open.pop();
+            const Label lab = labels[top.label];
+            int u = lab.node;
+
+            if (dominated(u, lab.negLogRel, end, top.negLogRel)) continue;
+            bestRel[u] = lab.negLogRel;
+            ++labelsSettled;
+
+            if (u == end) {
+                front.push_back({ lab.cost, exp(-lab.negLogRel), tracePath(top.label) });
+                if (maxRoutes > 0 && (int)front.size() >= maxRoutes) break;
+                continue;
+            }
+
+            for (int k = graph.csrOffset[u]; k < graph.csrOffset[u + 1]; ++k) {
+                if (!graph.arcAvailable[k]) continue;
+                int v = graph.csrTo[k];
+                if (costBound[v] == INF) continue;
+                long long c = lab.cost + graph.csrCost[k];
+                double r = lab.negLogRel + graph.csrNegLogRel[k];
+                if (dominated(v, r, end, r + relBound[v])) continue;
+                labels.push_back({ v, top.label, c, r });
+                open.push({ c + (long long)costBound[v], r + relBound[v], (int)labels.size() - 1 });
+                ++labelsCreated;
+            }
+        }
+        return front;
+    }
+
+    // Cheapest route with reliability >= minReliability, nullptr if none
+    static const ParetoRoute* cheapestAbove(const vector<ParetoRoute>& front, double minReliability) {
+        for (const ParetoRoute& r : front)
+            if (r.reliability >= minReliability) return &r;
+        return nullptr;
+    }
+
+    // Most reliable route costing at most maxCost, nullptr if none
+    static const ParetoRoute* mostReliableWithin(const vector<ParetoRoute>& front, long long maxCost) {
+        const ParetoRoute* best = nullptr;
+        for (const ParetoRoute& r : front)
+            if (r.cost <= maxCost) best = &r;
+        return best;
+    }
+
+private:
+    struct Label {
+        int node;
+        int pred;                   // label index, -1 at start
+        long long cost;
+        double negLogRel;
+    };
+
+    struct Entry {
+        long long cost;             // cost + lower bound
+        double negLogRel;           // -log rel + lower bound
+        int label;
+        bool operator>(const Entry& o) const {
+            if (cost != o.cost) return cost > o.cost;
+            return negLogRel > o.negLogRel;
+        }
+    };
+
+    vector<Label> labels;
+    vector<double> bestRel;         // node -> smallest -log rel settled so far
+    vector<double> costBound, relBound;
+
+    bool dominated(int v, double r, int end, double rTarget) const {
+        return r >= bestRel[v] - relEpsilon || rTarget >= bestRel[end] - relEpsilon;
+    }
+
+    vector<int> tracePath(int label) const {
+        vector<int> path;
+        for (int l = label; l != -1; l = labels[l].pred) path.push_back(labels[l].node);
+        reverse(path.begin(), path.end());
+        return path;
+    }
+
+    // Exact distances to `end` under cost and under -log rel (undirected graph)
+    void lowerBounds(int end, vector<double>& cost, vector<double>& rel) const {
+        reverseSearch(end, cost, [&](int k) { return (double)graph.csrCost[k]; });
+        reverseSearch(end, rel, [&](int k) { return graph.csrNegLogRel[k]; });
+    }
+
+    template <class WeightFn>
+    void reverseSearch(int end, vector<double>& dist, WeightFn weight) const {
+        dist.assign(graph.N, numeric_limits<double>::max());
+        priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> pq;
+        dist[end] = 0.0;
+        pq.push({ 0.0, end });
+        while (!pq.empty()) {
+            auto [d, u] = pq.top();
+            pq.pop();
+            if (d > dist[u]) continue;
+            for (int k = graph.csrOffset[u]; k < graph.csrOffset[u + 1]; ++k) {
+                if (!graph.arcAvailable[k]) continue;
+                int v = graph.csrTo[k];
+                double nd = d + weight(k);
+                if (nd < dist[v]) { dist[v] = nd; pq.push({ nd, v }); }
+            }
+        }
+    }
+};
+
+#endif
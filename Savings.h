@@ -0,0 +1,160 @@
+#ifndef SAVINGS_H
+#define SAVINGS_H
+
+#include <vector>
+#include <queue>
+#include <deque>
+#include <algorithm>
+#include <climits>
+#include "Graph.h"
+#include "vehicle.h"
+#include "CapacityIndex.h"
+
+using namespace std;
+
+// ==========================================
+// Clarke-Wright savings allocator
+// Every stop starts on its own depot -> stop -> depot route. Pairs
+// (i, j) of equal priority are merged in order of saving
+// d(0,i) + d(0,j) - d(i,j) when both are route ends and the joined
+// load fits the largest vehicle, so every route is one priority class.
+// Savings come only from each stop's kNearest stops, found by a short
+// search from each stop. Depot distances come from one full search.
+// There is no full stop x stop table.
+// Capacity is then filled a class at a time, highest priority first:
+// the class's routes go best-fit (largest load first, at most one per
+// vehicle per class), then stops of its routes no vehicle could take
+// are placed one by one into the remaining capacity. Lower classes
+// only get what is left, so a shortage leaves the least urgent unserved.
+// Stops the depot cannot reach are left unassigned.
+// ==========================================
+struct SavingsAllocator {
+    const Graph& graph;
+    double alpha = 1.0, beta = 1.0;
+    int kNearest = 10;
+    int merges = 0;                 // last call
+
+    SavingsAllocator(const Graph& g) : graph(g) {}
+
+    // Stops per vehicle, in route order
+    vector<vector<int>> allocate(const vector<Vehicle>& vehicles) {
+        const double INF = numeric_limits<double>::max();
+        vector<vector<int>> assigned(vehicles.size());
+        merges = 0;
+
+        DijkstraWorkspace ws;
+        graph.dijkstraSearch(ws, 0, 0, alpha, beta, false);
+        vector<double> depotDist(graph.N);
+        for (int v = 0; v < graph.N; ++v) depotDist[v] = ws.getDist(v);
+
+        vector<char> isStop(graph.N, 0);
+        vector<int> stops;
+        for (const Node& n : graph.nodes)
+            if (n.id != 0 && depotDist[n.id] != INF) { isStop[n.id] = 1; stops.push_back(n.id); }
+
+        int maxCapacity = 0;
+        for (const Vehicle& v : vehicles) maxCapacity = max(maxCapacity, v.capacity);
+
+        // One route per stop
+        vector<int> routeOf(graph.N, -1);
+        vector<deque<int>> routes;
+        vector<int> load;
+        for (int s : stops) {
+            routeOf[s] = routes.size();
+            routes.push_back({ s });
+            load.push_back(graph.nodes[s].demand);
+        }
+
+        priority_queue<Saving> heap;
+        for (int s : stops) {
+            int found = 0;
+            ws.reset(graph.N);
+            graph.runDijkstra(ws, ws.heap, s, alpha, beta, [&](int u) {
+                if (u == s || !isStop[u] || graph.nodes[u].priority != graph.nodes[s].priority) return false;
+                heap.push({ depotDist[s] + depotDist[u] - ws.dist[u], s, u });
+                return ++found >= kNearest;
+            });
+        }
+
+        while (!heap.empty()) {
+            Saving sv = heap.top();
+            heap.pop();
+            if (sv.value <= 0) break;
+            int a = routeOf[sv.i], b = routeOf[sv.j];
+            if (a == b || load[a] + load[b] > maxCapacity) continue;
+            if (!isEnd(routes[a], sv.i) || !isEnd(routes[b], sv.j)) continue;
+
+            // Join as ... i | j ..., keeping the longer route in place
+            if (routes[a].size() < routes[b].size()) { swap(a, b); swap(sv.i, sv.j); }
+            deque<int>& keep = routes[a];
+            deque<int>& take = routes[b];
+            bool atBack = keep.back() == sv.i;
+            if ((take.front() == sv.j) != atBack) reverse(take.begin(), take.end());
+            for (int v : take) routeOf[v] = a;
+            if (atBack) keep.insert(keep.end(), take.begin(), take.end());
+            else keep.insert(keep.begin(), take.begin(), take.end());
+            take.clear();
+            load[a] += load[b];
+            load[b] = 0;
+            ++merges;
+        }
+
+        assignRoutes(routes, load, vehicles, assigned);
+        return assigned;
+    }
+
+private:
+    struct Saving {
+        double value;
+        int i, j;
+        bool operator<(const Saving& o) const { return value < o.value; }
+    };
+
+    static bool isEnd(const deque<int>& r, int v) { return r.front() == v || r.back() == v; }
+
+    void assignRoutes(const vector<deque<int>>& routes, const vector<int>& load,
+                      const vector<Vehicle>& vehicles, vector<vector<int>>& assigned) const {
+        vector<int> order;
+        for (int r = 0; r < (int)routes.size(); ++r)
+            if (!routes[r].empty()) order.push_back(r);
+        auto priority = [&](int r) { return graph.nodes[routes[r].front()].priority; };
+        sort(order.begin(), order.end(), [&](int a, int b) {
+            if (priority(a) != priority(b)) return priority(a) > priority(b);
+            return load[a] > load[b];
+        });
+
+        CapacityIndex fleet;
+        fleet.init(vehicles);
+
+        for (size_t c0 = 0; c0 < order.size();) {
+            size_t c1 = c0;
+            while (c1 < order.size() && priority(order[c1]) == priority(order[c0])) ++c1;
+
+            vector<int> leftover;
+            for (size_t i = c0; i < c1; ++i) {
+                int r = order[i];
+                int best = fleet.bestFit(load[r]);
+                if (best == -1) {
+                    leftover.insert(leftover.end(), routes[r].begin(), routes[r].end());
+                    continue;
+                }
+                fleet.take(best, load[r]);
+                fleet.remove(best);     // one route per vehicle per class
+                assigned[best].insert(assigned[best].end(), routes[r].begin(), routes[r].end());
+            }
+
+            // Remaining capacity of every vehicle is open to single stops
+            for (size_t i = 0; i < vehicles.size(); ++i) fleet.restore(i);
+            for (int v : leftover) {
+                int demand = graph.nodes[v].demand;
+                int best = fleet.bestFit(demand);
+                if (best == -1) continue;
+                fleet.take(best, demand);
+                assigned[best].push_back(v);
+            }
+            c0 = c1;
+        }
+    }
+};
+
+#endif
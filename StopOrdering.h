@@ -0,0 +1,187 @@
+#ifndef STOPORDERING_H
+#define STOPORDERING_H
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <deque>
+
+using namespace std;
+
+// ==========================================
+// Stop ordering for one vehicle: nearest neighbour, then 2-opt and
+// Or-opt local search
+// Points are local ids over a dense m x m cost table. Point 0 is the
+// fixed start, point m - 1 the fixed end, and 1..m-2 are the stops to
+// order. With openEnd the end is a dummy reached at zero cost, so the
+// path may finish anywhere. Costs are assumed symmetric (undirected
+// roads), which reversing a 2-opt segment relies on.
+// Moves are only tried between a stop and its neighbourCount nearest
+// stops. Don't-look bits (a work queue of stops) skip stops whose
+// surroundings have not changed since they last failed to improve.
+// ==========================================
+struct StopOrdering {
+    int neighbourCount = 8;
+    int twoOptMoves = 0;            // accepted moves, last call
+    int orOptMoves = 0;
+
+    vector<int> order(const vector<double>& table, int m, bool openEnd) {
+        d = &table;
+        size = m;
+        open = openEnd;
+        twoOptMoves = orOptMoves = 0;
+        int n = m - 2;
+        if (n <= 0) return {};
+
+        nearestNeighbour(n);
+        if (n >= 3) {
+            buildNeighbours(n);
+            localSearch(n);
+        }
+        return vector<int>(seq.begin() + 1, seq.end() - 1);
+    }
+
+    double pathCost(const vector<int>& stops) const {
+        double total = 0.0;
+        int prev = 0;
+        for (int s : stops) { total += cost(prev, s); prev = s; }
+        return total + cost(prev, size - 1);
+    }
+
+private:
+    const vector<double>* d = nullptr;
+    int size = 0;
+    bool open = false;
+    vector<int> seq;                // 0, stops..., m - 1
+    vector<int> pos;                // point -> index in seq
+    vector<vector<int>> near;       // stop -> nearest stops, closest first
+    vector<char> queued;
+    deque<int> work;
+
+    double cost(int a, int b) const {
+        if (open && (a == size - 1 || b == size - 1)) return 0.0;
+        return (*d)[size_t(a) * size + b];
+    }
+
+    void nearestNeighbour(int n) {
+        vector<char> used(size, 0);
+        seq.assign(1, 0);
+        for (int step = 0; step < n; ++step) {
+            int last = seq.back(), best = -1;
+            for (int s = 1; s <= n; ++s)
+                if (!used[s] && (best == -1 || cost(last, s) < cost(last, best))) best = s;
+            used[best] = 1;
+            seq.push_back(best);
+        }
+        seq.push_back(size - 1);
+        pos.assign(size, 0);
+        for (int i = 0; i < (int)seq.size(); ++i) pos[seq[i]] = i;
+    }
+
+    void buildNeighbours(int n) {
+        int k = min(neighbourCount, n - 1);
+        near.assign(size, {});
+        vector<int> all;
+        for (int s = 1; s <= n; ++s) {
+            all.resize(n);
+            iota(all.begin(), all.end(), 1);
+            all.erase(all.begin() + (s - 1));
+            partial_sort(all.begin(), all.begin() + k, all.end(),
+                         [&](int a, int b) { return cost(s, a) < cost(s, b); });
+            near[s].assign(all.begin(), all.begin() + k);
+        }
+    }
+
+    void push(int p) {
+        if (p <= 0 || p >= size - 1 || queued[p]) return;
+        queued[p] = 1;
+        work.push_back(p);
+    }
+
+    void localSearch(int n) {
+        queued.assign(size, 0);
+        work.clear();
+        for (int i = 1; i <= n; ++i) push(seq[i]);
+        while (!work.empty()) {
+            int a = work.front();
+            work.pop_front();
+            queued[a] = 0;
+            if (twoOpt(a) || orOpt(a)) push(a);
+        }
+    }
+
+    void reverseRange(int i, int j) {
+        for (; i < j; ++i, --j) {
+            swap(seq[i], seq[j]);
+            pos[seq[i]] = i;
+            pos[seq[j]] = j;
+        }
+    }
+
+    // Remove edges (seq[i], seq[i+1]) and (seq[j], seq[j+1]), i < j,
+    // by reversing seq[i+1..j]; pushes the four endpoints
+    bool tryReverse(int i, int j) {
+        if (i < 0 || j >= size - 1 || i + 1 >= j) return false;
+        int a = seq[i], b = seq[i + 1], c = seq[j], e = seq[j + 1];
+        double delta = cost(a, c) + cost(b, e) - cost(a, b) - cost(c, e);
+        if (delta > -1e-9) return false;
+        reverseRange(i + 1, j);
+        push(a); push(b); push(c); push(e);
+        ++twoOptMoves;
+        return true;
+    }
+
+    bool twoOpt(int a) {
+        int i = pos[a];
+        for (int c : near[a]) {
+            int j = pos[c];
+            // a gets c as successor, or as predecessor
+            if (j > i ? tryReverse(i, j) : tryReverse(j, i)) return true;
+            if (j > i ? tryReverse(i - 1, j - 1) : tryReverse(j - 1, i - 1)) return true;
+        }
+        return false;
+    }
+
+    // Move a segment of 1..3 stops starting at a next to one of a's
+    // neighbours, in either direction
+    bool orOpt(int a) {
+        int last = size - 2;        // last movable index
+        for (int len = 1; len <= 3; ++len) {
+            int i = pos[a];
+            int j = i + len - 1;
+            if (j > last) break;
+            int p = seq[i - 1], s0 = seq[i], s1 = seq[j], nx = seq[j + 1];
+            double gain = cost(p, s0) + cost(s1, nx) - cost(p, nx);
+            if (gain <= 1e-9) continue;
+
+            for (int c : near[a]) {
+                int q = pos[c];
+                for (int at : { q - 1, q }) {           // insert between seq[at] and seq[at + 1]
+                    if (at < 0 || at + 1 > size - 1) continue;
+                    if (at >= i - 1 && at <= j) continue;
+                    int x = seq[at], y = seq[at + 1];
+                    double fwd = cost(x, s0) + cost(s1, y) - cost(x, y);
+                    double rev = cost(x, s1) + cost(s0, y) - cost(x, y);
+                    bool reversed = rev < fwd;
+                    if (min(fwd, rev) - gain > -1e-9) continue;
+                    moveSegment(i, j, at, reversed);
+                    push(p); push(nx); push(x); push(y); push(s0); push(s1);
+                    ++orOptMoves;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void moveSegment(int i, int j, int at, bool reversed) {
+        vector<int> seg(seq.begin() + i, seq.begin() + j + 1);
+        if (reversed) reverse(seg.begin(), seg.end());
+        seq.erase(seq.begin() + i, seq.begin() + j + 1);
+        if (at > j) at -= seg.size();
+        seq.insert(seq.begin() + at + 1, seg.begin(), seg.end());
+        for (int k = 0; k < (int)seq.size(); ++k) pos[seq[k]] = k;
+    }
+};
+
+#endif
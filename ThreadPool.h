@@ -0,0 +1,97 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+
+using namespace std;
+
+// ==========================================
+// Fixed pool of workers for fork-join style loops.
+// run(fn) calls fn(worker) on every worker (the calling thread is
+// worker 0) and returns when all are done, so it can be used for many
+// short phases without respawning threads. A pool of size 1 runs
+// everything inline.
+// ==========================================
+struct ThreadPool {
+    ThreadPool(unsigned n = 0) {
+        if (n == 0) n = max(1u, thread::hardware_concurrency());
+        count = n;
+        for (unsigned i = 1; i < count; ++i)
+            workers.emplace_back([this, i] { loop(i); });
+    }
+
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lock(m);
+            stopping = true;
+            ++phase;
+        }
+        wake.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return count; }
+
+    void run(const function<void(unsigned)>& fn) {
+        if (count == 1) { fn(0); return; }
+        {
+            lock_guard<mutex> lock(m);
+            job = &fn;
+            pending = count - 1;
+            ++phase;
+        }
+        wake.notify_all();
+        fn(0);
+        unique_lock<mutex> lock(m);
+        done.wait(lock, [&] { return pending == 0; });
+        job = nullptr;
+    }
+
+    // body(i, worker) for every i in [0, n), handed out in chunks
+    void parallelFor(size_t n, const function<void(size_t, unsigned)>& body, size_t chunk = 64) {
+        atomic<size_t> next(0);
+        run([&](unsigned w) {
+            for (size_t begin = next.fetch_add(chunk); begin < n; begin = next.fetch_add(chunk))
+                for (size_t i = begin; i < min(n, begin + chunk); ++i) body(i, w);
+        });
+    }
+
+private:
+    unsigned count;
+    vector<thread> workers;
+    mutex m;
+    condition_variable wake, done;
+    const function<void(unsigned)>* job = nullptr;
+    unsigned pending = 0;
+    unsigned long long phase = 0;
+    bool stopping = false;
+
+    void loop(unsigned id) {
+        unsigned long long seen = 0;
+        while (true) {
+            const function<void(unsigned)>* fn;
+            {
+                unique_lock<mutex> lock(m);
+                wake.wait(lock, [&] { return phase != seen; });
+                seen = phase;
+                if (stopping) return;
+                fn = job;
+            }
+            (*fn)(id);
+            {
+                lock_guard<mutex> lock(m);
+                if (--pending == 0) done.notify_one();
+            }
+        }
+    }
+};
+
+#endif
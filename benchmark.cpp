@@ -0,0 +1,233 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include "Graph.h"
+#include "DeltaStepping.h"
+#include "CapacityIndex.h"
+#include "DynamicSSSP.h"
+#include "json.hpp"
+
+using json = nlohmann::json;
+using namespace std;
+
+// Sequential Dijkstra vs parallel delta-stepping, full single-source trees.
+// Usage: benchmark [--threads=T] [--sources=S] [--synthetic=N] [dataset.json ...]
+// With no datasets, dataset_10..13 are used. --synthetic=0 skips the
+// random N-node grid (default 1M nodes).
+//
+// benchmark --allocation [--points=P] times best-fit vehicle selection,
+// fleet scan vs CapacityIndex, for growing fleet sizes.
+//
+// benchmark --closures=C [dataset.json ...] closes C random edges one at
+// a time and keeps a depot tree current, ShortestPathTree::repair vs a
+// full Dijkstra per closure.
+
+static bool loadGraph(const string& path, Graph& g) {
+    ifstream file(path);
+    if (!file) return false;
+    json cfg;
+    file >> cfg;
+    g = Graph(cfg["graph"]["num_nodes"]);
+    for (auto& je : cfg["graph"]["edges"]) {
+        int u = je.value("u", -1);
+        int v = je.value("v", -1);
+        if (u >= 0 && v >= 0) g.addEdge(u, v, je.value("cost", 0), je.value("reliability", 1.0));
+    }
+    g.freeze();
+    return true;
+}
+
+// side x side grid, 4-neighbour two-way roads plus a few random shortcuts
+static void syntheticGraph(int n, Graph& g) {
+    int side = max(2, (int)sqrt((double)n));
+    n = side * side;
+    g = Graph(n);
+    mt19937 rng(12345);
+    uniform_int_distribution<int> cost(1, 20);
+    uniform_real_distribution<double> rel(0.6, 1.0);
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            int u = r * side + c;
+            // addEdge already adds both directions
+            if (c + 1 < side) { int w = cost(rng); double p = rel(rng); g.addEdge(u, u + 1, w, p); }
+            if (r + 1 < side) { int w = cost(rng); double p = rel(rng); g.addEdge(u, u + side, w, p); }
+        }
+    }
+    uniform_int_distribution<int> node(0, n - 1);
+    for (int i = 0; i < n / 100; ++i) g.addEdge(node(rng), node(rng), 40 + cost(rng), rel(rng));
+    g.freeze();
+}
+
+static void benchmark(const string& name, const Graph& g, ThreadPool& pool, int sources) {
+    DijkstraWorkspace ws;
+    DeltaStepping ds(g, pool);
+    mt19937 rng(7);
+    double seqMs = 0, parMs = 0, maxDiff = 0;
+    int rounds = 0;
+    for (int s = 0; s < sources; ++s) {
+        int src = rng() % g.N;
+        auto t0 = chrono::steady_clock::now();
+        g.dijkstraSearch(ws, src, src, 1.0, 1.0, false);
+        auto t1 = chrono::steady_clock::now();
+        ds.run(src, 1.0, 1.0);
+        auto t2 = chrono::steady_clock::now();
+        seqMs += chrono::duration<double, milli>(t1 - t0).count();
+        parMs += chrono::duration<double, milli>(t2 - t1).count();
+        rounds += ds.rounds;
+        for (int v = 0; v < g.N; ++v) {
+            double a = ws.getDist(v), b = ds.dist[v];
+            if (a == b) continue;
+            maxDiff = max(maxDiff, (a == numeric_limits<double>::max() || b == numeric_limits<double>::max())
+                ? numeric_limits<double>::infinity() : fabs(a - b));
+        }
+    }
+    cout << left << setw(18) << name << right << setw(9) << g.N << setw(10) << g.edges.size()
+         << fixed << setprecision(1) << setw(12) << seqMs / sources << setw(12) << parMs / sources
+         << setprecision(2) << setw(9) << seqMs / parMs << setw(8) << rounds / sources
+         << scientific << setprecision(1) << setw(10) << maxDiff << defaultfloat << "\n";
+}
+
+// Best-fit over `demands` in order; returns the vehicle chosen per demand
+static vector<int> bestFitScan(const vector<int>& demands, const vector<Vehicle>& fleet) {
+    vector<int> remaining(fleet.size()), choice;
+    for (size_t i = 0; i < fleet.size(); ++i) remaining[i] = fleet[i].capacity;
+    for (int d : demands) {
+        int best = -1;
+        for (size_t i = 0; i < fleet.size(); ++i)
+            if (remaining[i] >= d && (best == -1 || remaining[i] < remaining[best])) best = i;
+        if (best != -1) remaining[best] -= d;
+        choice.push_back(best);
+    }
+    return choice;
+}
+
+static vector<int> bestFitIndexed(const vector<int>& demands, const vector<Vehicle>& fleet) {
+    CapacityIndex index;
+    index.init(fleet);
+    vector<int> choice;
+    for (int d : demands) {
+        int best = index.bestFit(d);
+        if (best != -1) index.take(best, d);
+        choice.push_back(best);
+    }
+    return choice;
+}
+
+static void allocationBenchmark(int points) {
+    mt19937 rng(99);
+    vector<int> demands(points);
+    long long total = 0;
+    for (int& d : demands) { d = 1 + rng() % 20; total += d; }
+    sort(demands.rbegin(), demands.rend());
+
+    cout << "Demand points: " << points << "\n";
+    cout << right << setw(8) << "fleet" << setw(12) << "scan ms" << setw(12) << "index ms"
+         << setw(10) << "speedup" << setw(8) << "same" << "\n";
+    for (int V : { 10, 100, 1000, 10000 }) {
+        vector<Vehicle> fleet(V);
+        for (int i = 0; i < V; ++i) {
+            fleet[i].id = i;
+            fleet[i].capacity = int(total / V) + int(rng() % 40) - 20;
+        }
+
+        auto t0 = chrono::steady_clock::now();
+        vector<int> a = bestFitScan(demands, fleet);
+        auto t1 = chrono::steady_clock::now();
+        vector<int> b = bestFitIndexed(demands, fleet);
+        auto t2 = chrono::steady_clock::now();
+        double scanMs = chrono::duration<double, milli>(t1 - t0).count();
+        double indexMs = chrono::duration<double, milli>(t2 - t1).count();
+        cout << setw(8) << V << fixed << setprecision(1) << setw(12) << scanMs << setw(12) << indexMs
+             << setprecision(1) << setw(10) << scanMs / indexMs << setw(8) << (a == b ? "yes" : "NO")
+             << defaultfloat << "\n";
+    }
+}
+
+static void closureBenchmark(const string& name, Graph& g, int closures) {
+    mt19937 rng(7);
+    ShortestPathTree tree;
+    tree.build(g, 0, 1.0, 1.0);
+    DijkstraWorkspace ws;
+    double repairMs = 0, rebuildMs = 0, maxDiff = 0;
+    for (int c = 0; c < closures; ++c) {
+        vector<int> closed = { int(rng() % g.edges.size()) };
+        g.setEdgesAvailability(closed, false);
+
+        auto t0 = chrono::steady_clock::now();
+        tree.repair(g, closed);
+        auto t1 = chrono::steady_clock::now();
+        g.dijkstraSearch(ws, 0, 0, 1.0, 1.0, false);
+        auto t2 = chrono::steady_clock::now();
+        repairMs += chrono::duration<double, milli>(t1 - t0).count();
+        rebuildMs += chrono::duration<double, milli>(t2 - t1).count();
+        for (int v = 0; v < g.N; ++v) {
+            double a = tree.dist[v], b = ws.getDist(v);
+            if (a != b) maxDiff = max(maxDiff, (a == numeric_limits<double>::max() || b == numeric_limits<double>::max())
+                                                   ? numeric_limits<double>::infinity() : fabs(a - b));
+        }
+    }
+    cout << left << setw(18) << name << right << setw(9) << g.N << setw(10) << closures << fixed << setprecision(2)
+         << setw(12) << repairMs << setw(12) << rebuildMs << setprecision(1) << setw(9) << rebuildMs / repairMs
+         << setw(12) << double(tree.totalAffected) / closures << defaultfloat << setw(10) << maxDiff << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    unsigned threads = 0;
+    int sources = 5;
+    int synthetic = 1000000;
+    vector<string> files;
+    bool allocation = false;
+    int points = 100000;
+    int closures = 0;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--allocation") allocation = true;
+        else if (arg.rfind("--closures=", 0) == 0) closures = stoi(arg.substr(11));
+        else if (arg.rfind("--points=", 0) == 0) points = stoi(arg.substr(9));
+        else if (arg.rfind("--threads=", 0) == 0) threads = stoi(arg.substr(10));
+        else if (arg.rfind("--sources=", 0) == 0) sources = max(1, stoi(arg.substr(10)));
+        else if (arg.rfind("--synthetic=", 0) == 0) synthetic = stoi(arg.substr(12));
+        else files.push_back(arg);
+    }
+    if (allocation) {
+        allocationBenchmark(points);
+        return 0;
+    }
+    if (files.empty()) files = { "dataset_10.json", "dataset_11.json", "dataset_12.json", "dataset_13.json" };
+
+    Graph g(0);
+    if (closures > 0) {
+        cout << left << setw(18) << "graph" << right << setw(9) << "nodes" << setw(10) << "closures"
+             << setw(12) << "repair ms" << setw(12) << "rebuild ms" << setw(9) << "speedup"
+             << setw(12) << "avg nodes" << setw(10) << "max diff" << "\n";
+        for (const string& f : files) {
+            if (!loadGraph(f, g)) { cerr << "Failed to open file: " << f << endl; continue; }
+            closureBenchmark(f, g, closures);
+        }
+        if (synthetic > 0) {
+            syntheticGraph(synthetic, g);
+            closureBenchmark("synthetic grid", g, closures);
+        }
+        return 0;
+    }
+
+    ThreadPool pool(threads);
+    cout << "Threads: " << pool.size() << ", sources per graph: " << sources << "\n";
+    cout << left << setw(18) << "graph" << right << setw(9) << "nodes" << setw(10) << "edges"
+         << setw(12) << "dijkstra ms" << setw(12) << "delta ms" << setw(9) << "speedup"
+         << setw(8) << "rounds" << setw(10) << "max diff" << "\n";
+
+    for (const string& f : files) {
+        if (!loadGraph(f, g)) { cerr << "Failed to open file: " << f << endl; continue; }
+        benchmark(f, g, pool, sources);
+    }
+    if (synthetic > 0) {
+        syntheticGraph(synthetic, g);
+        benchmark("synthetic grid", g, pool, sources);
+    }
+    return 0;
+}
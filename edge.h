@@ -4,3 +4,11 @@ struct Edge {
     int cost;       // travel time
     double reliability;
 };
+
+// Adjacency entry: one per direction of an undirected Edge
+struct Arc {
+    int to;
+    int cost;
+    double reliability;
+    int edge;       // id into Graph::edges / Graph::edgeAvailable
+};
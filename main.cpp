@@ -8,18 +8,92 @@
 #include "DisasterManager.h"
 #include "json.hpp"
 #include <filesystem>
+#include <chrono>
+#include <sstream>
 
 using json = nlohmann::json;
 using namespace std;
 
 int main(int argc, char* argv[]) {
 
-    // Determine file path
-    string filepath;
-    if (argc > 1) {
-        filepath = argv[1]; // Path from command line
-    } else {
-        filepath = "input.json"; // Default file in same folder as exe
+    // Determine file path and options
+    string filepath = "input.json"; // Default file in same folder as exe
+    bool useStopMatrix = false;
+    bool deltaStepping = false;
+    bool trackClosures = false;
+    bool optimizeStopOrder = false, strictPriority = false;
+    Allocator allocator = Allocator::BestFit;
+    unsigned routeThreads = 0;
+    double alnsMs = 0;
+    vector<pair<int, int>> replanClosed;
+    double progress = 0.5;
+    unsigned alnsThreads = 1;
+    bool showStats = false;
+    RouteEngine engine = RouteEngine::Dijkstra;
+    HeapKind heapKind = HeapKind::Binary;
+    double alpha = 1.0, beta = 1.0;
+    bool specializeKernels = true;
+    int landmarkCount = 8;
+    string landmarkCache;
+    vector<int> closedRegion;
+    int paretoFrom = -1, paretoTo = -1;
+    int maxRoutes = 0;
+    double relEpsilon = -1;
+    vector<pair<double, double>> sweepWeights;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--stop-matrix") useStopMatrix = true; // precompute stop x stop costs
+        else if (arg == "--delta-stepping") deltaStepping = true; // stop matrix rows via parallel delta-stepping
+        else if (arg == "--track-closures") trackClosures = true; // stop matrix refreshes only rows a closure hits
+        else if (arg == "--optimize-order") optimizeStopOrder = true;   // 2-opt / Or-opt stop order per vehicle
+        else if (arg == "--strict-priority") strictPriority = true;     // ...only within equal priority
+        else if (arg == "--alloc=bestfit") allocator = Allocator::BestFit;
+        else if (arg == "--alloc=savings") allocator = Allocator::Savings;  // Clarke-Wright
+        else if (arg == "--alloc=cluster") allocator = Allocator::Cluster;  // capacitated k-medoids
+        else if (arg == "--stats") showStats = true;      // print routing work and timings
+        else if (arg == "--engine=dijkstra") engine = RouteEngine::Dijkstra;
+        else if (arg == "--engine=bidir") engine = RouteEngine::Bidirectional;
+        else if (arg == "--engine=alt") engine = RouteEngine::ALT;
+        else if (arg == "--engine=ch") engine = RouteEngine::CH;
+        else if (arg == "--engine=cch") engine = RouteEngine::CCH;
+        else if (arg == "--heap=binary") heapKind = HeapKind::Binary;
+        else if (arg == "--heap=4ary") heapKind = HeapKind::Quaternary;
+        else if (arg == "--heap=radix") heapKind = HeapKind::Radix;
+        else if (arg == "--generic-kernel") specializeKernels = false; // no beta=0 / alpha=0 kernels
+        else if (arg.rfind("--alpha=", 0) == 0) alpha = stod(arg.substr(8));
+        else if (arg.rfind("--beta=", 0) == 0) beta = stod(arg.substr(7));
+        else if (arg.rfind("--landmarks=", 0) == 0) landmarkCount = stoi(arg.substr(12));
+        else if (arg.rfind("--landmark-cache=", 0) == 0) landmarkCache = arg.substr(17);
+        else if (arg.rfind("--close-region=", 0) == 0) { // close every edge inside a node set, e.g. 5,6,9
+            stringstream ids(arg.substr(15));
+            for (string id; getline(ids, id, ',');) closedRegion.push_back(stoi(id));
+        }
+        else if (arg.rfind("--pareto=", 0) == 0) { // print the cost / reliability frontier U -> V
+            size_t comma = arg.find(',');
+            paretoFrom = stoi(arg.substr(9, comma - 9));
+            paretoTo = stoi(arg.substr(comma + 1));
+        }
+        else if (arg.rfind("--sweep=", 0) == 0) { // compare plans for A:B,A:B,... weightings
+            stringstream pairs(arg.substr(8));
+            for (string w; getline(pairs, w, ',');) {
+                size_t colon = w.find(':');
+                sweepWeights.push_back({ stod(w.substr(0, colon)), stod(w.substr(colon + 1)) });
+            }
+        }
+        else if (arg.rfind("--route-threads=", 0) == 0) routeThreads = stoi(arg.substr(16)); // 0 = all cores
+        else if (arg.rfind("--alns=", 0) == 0) alnsMs = stod(arg.substr(7));            // ALNS time budget, ms
+        else if (arg.rfind("--alns-threads=", 0) == 0) alnsThreads = stoi(arg.substr(15));
+        else if (arg.rfind("--replan=", 0) == 0) { // close U:V,U:V,... after planning, vehicles en route
+            stringstream pairs(arg.substr(9));
+            for (string e; getline(pairs, e, ',');) {
+                size_t colon = e.find(':');
+                replanClosed.push_back({ stoi(e.substr(0, colon)), stoi(e.substr(colon + 1)) });
+            }
+        }
+        else if (arg.rfind("--progress=", 0) == 0) progress = stod(arg.substr(11)); // route share travelled
+        else if (arg.rfind("--max-routes=", 0) == 0) maxRoutes = stoi(arg.substr(13)); // Pareto: cheapest N frontier routes only
+        else if (arg.rfind("--rel-epsilon=", 0) == 0) relEpsilon = stod(arg.substr(14));
+        else filepath = arg; // Path from command line
     }
 
     // Print current working directory
@@ -58,6 +132,7 @@ int main(int argc, char* argv[]) {
     double rel = je.value("reliability", 1.0);
     if(u >= 0 && v >= 0) g.addEdge(u, v, cost, rel);
 }
+    g.freeze(); // pack adjacency into CSR for the routing queries
 
 
     // Load vehicles
@@ -71,15 +146,104 @@ int main(int argc, char* argv[]) {
 
     g.setEdgeAvailability(3, 4, false);
     g.setEdgeAvailability(4, 3, false);
+    if (!closedRegion.empty())
+        cout << "Closed " << g.closeRegion(closedRegion) << " edges inside the region" << endl;
 
     // Create DisasterManager
     DisasterManager dm(g, vehicles);
+    dm.useStopMatrix = useStopMatrix;
+    dm.stopCosts.deltaStepping = deltaStepping;
+    dm.stopCosts.trackClosures = trackClosures;
+    dm.optimizeStopOrder = optimizeStopOrder;
+    dm.allocator = allocator;
+    dm.routeThreads = routeThreads;
+    dm.improveBudgetMs = alnsMs;
+    dm.improveThreads = alnsThreads;
+    dm.strictPriorityOrder = strictPriority;
+    dm.engine = engine;
+    dm.heapKind = heapKind;
+    dm.specializeKernels = specializeKernels;
+    dm.alpha = alpha;
+    dm.beta = beta;
+    dm.landmarkCount = landmarkCount;
+    dm.landmarkCachePath = landmarkCache.empty() ? filepath + ".alt" : landmarkCache;
+
+    if (!sweepWeights.empty()) {
+        dm.landmarkCachePath.clear();
+        auto t0 = chrono::steady_clock::now();
+        vector<SweepResult> rows = dm.sweep(sweepWeights);
+        auto t1 = chrono::steady_clock::now();
+        cout << "alpha\tbeta\tcost\treliability\tpriority\tidle\tutilization%\troute ms\n";
+        for (const SweepResult& r : rows) {
+            cout << r.alpha << "\t" << r.beta << "\t" << r.metrics.totalCost << "\t"
+                 << r.metrics.avgReliability << "\t" << r.metrics.prioritySatisfaction << "\t"
+                 << r.metrics.idleVehicles << "\t" << r.metrics.utilization << "\t" << r.routingMs << "\n";
+        }
+        cout << "Sweep time: " << chrono::duration<double, milli>(t1 - t0).count() << " ms\n";
+        return 0;
+    }
 
     // Allocate nodes to vehicles and compute routes
+    auto t0 = chrono::steady_clock::now();
     dm.allocateAndRoute();
+    auto t1 = chrono::steady_clock::now();
+
+    if (showStats) {
+        cout << "Routing time: " << chrono::duration<double, milli>(t1 - t0).count() << " ms\n";
+        cout << "Settled nodes: " << dm.settledNodes << "\n";
+        if (engine == RouteEngine::Dijkstra) {
+            const HeapStats& hs = dm.heapTotals;
+            cout << "Heap pushes: " << hs.pushes << ", pops: " << hs.pops
+                 << ", stale pops: " << hs.stalePops << ", decrease-keys: " << hs.decreaseKeys << "\n";
+        }
+        if (alnsMs > 0) {
+            const ALNSStats& st = dm.improveStats;
+            cout << "ALNS: " << st.iterations << " iterations (" << st.iterationsPerSecond() << "/s), "
+                 << st.accepted << " accepted, objective " << st.initialCost << " -> " << st.bestCost << "\n";
+        }
+        if (engine == RouteEngine::CCH) {
+            const CCHStats& st = dm.cch.stats;
+            cout << "CCH arcs: " << st.arcs << ", order: " << st.orderMs << " ms"
+                 << ", customization: " << st.customizeMs << " ms"
+                 << ", queries: " << st.queries << " (avg " << st.avgQueryMs() << " ms)\n";
+        }
+    }
+
+    if (!replanClosed.empty()) {
+        for (Vehicle& v : vehicles)
+            v.position = v.route.empty() ? 0 : int(progress * (v.route.size() - 1));
+        auto t2 = chrono::steady_clock::now();
+        ReplanResult rr = dm.replanClosures(replanClosed);
+        auto t3 = chrono::steady_clock::now();
+        cout << "Re-plan: " << rr.vehiclesAffected << " vehicles affected, " << rr.legsRerouted
+             << " legs rerouted, " << rr.stopsDropped << " stops dropped, "
+             << rr.matrixRowsRefreshed << " stop table rows refreshed ("
+             << chrono::duration<double, milli>(t3 - t2).count() << " ms)\n";
+        if (!rr.droppedStops.empty()) {
+            cout << "Unserved after re-plan:";
+            for (int n : rr.droppedStops) cout << " " << n;
+            cout << "\n";
+        }
+    }
 
     // Compute metrics and print routes
     dm.computeMetrics();
 
+    if (paretoFrom >= 0) {
+        dm.pareto.maxRoutes = maxRoutes;
+        if (relEpsilon >= 0) dm.pareto.relEpsilon = relEpsilon;
+        auto t2 = chrono::steady_clock::now();
+        vector<ParetoRoute> front = dm.routeOptions(paretoFrom, paretoTo);
+        auto t3 = chrono::steady_clock::now();
+        cout << "\nPareto routes " << paretoFrom << " -> " << paretoTo << ": " << front.size()
+             << " (" << chrono::duration<double, milli>(t3 - t2).count() << " ms, "
+             << dm.pareto.labelsSettled << " labels settled)\n";
+        for (const ParetoRoute& r : front) {
+            cout << "  cost " << r.cost << ", reliability " << r.reliability << ":";
+            for (int v : r.path) cout << " " << v;
+            cout << "\n";
+        }
+    }
+
     return 0;
 }
@@ -8,4 +8,10 @@ struct Vehicle {
     int capacity;
     vector<int> route;         // Full path including intermediate nodes: e.g., [0, 1, 2, 3, 0]
     vector<int> assignedNodes; // Only nodes assigned for delivery: e.g., [1, 3]
+    vector<int> stopIndex;     // route index where each assigned node is reached, -1 if unreachable
+    int position = 0;          // route index the vehicle has reached while en route
+
+    // Unserved stops (unreachable when routed, or cut off by a later
+    // closure) stay in assignedNodes with stopIndex -1
+    bool reaches(size_t k) const { return k >= stopIndex.size() || stopIndex[k] >= 0; }
 };
\ No newline at end of file
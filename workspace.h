@@ -0,0 +1,74 @@
+#pragma once
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include "Heaps.h"
+
+using namespace std;
+
+// Per-query scratch space reused across Dijkstra calls. Entries are
+// generation-stamped, so starting a new query is O(1) and only the
+// nodes a query actually touches are (lazily) reinitialised.
+// Dist is the label type: double for the weighted searches, an integer
+// type for the cost-only kernel (DijkstraKernels.h).
+template <class Dist>
+struct BasicDijkstraWorkspace {
+    vector<Dist> dist;
+    vector<int> parent;
+    vector<double> pathReli;
+    vector<unsigned> stamp;       // node -> generation that last wrote it
+    vector<unsigned> targetMark;  // node -> generation it is a pending target in
+    unsigned generation = 0;
+    BinaryHeap heap;              // default heap, storage kept between queries
+    int settled = 0;              // nodes settled by the last query
+
+    // Start a new query over an n-node graph
+    void reset(int n) {
+        if ((int)stamp.size() != n) {
+            dist.resize(n);
+            parent.resize(n);
+            pathReli.resize(n);
+            stamp.assign(n, 0);
+            targetMark.assign(n, 0);
+            generation = 0;
+        }
+        if (++generation == 0) {            // wrapped: clear stamps once
+            fill(stamp.begin(), stamp.end(), 0);
+            fill(targetMark.begin(), targetMark.end(), 0);
+            generation = 1;
+        }
+        heap.reset(n);
+        settled = 0;
+    }
+
+    bool touched(int v) const { return stamp[v] == generation; }
+
+    // Bring v into the current generation with its initial values
+    void touch(int v) {
+        if (stamp[v] == generation) return;
+        stamp[v] = generation;
+        dist[v] = numeric_limits<Dist>::max();
+        parent[v] = -1;
+        pathReli[v] = 0.0;
+    }
+
+    Dist getDist(int v) const {
+        return touched(v) ? dist[v] : numeric_limits<Dist>::max();
+    }
+
+    // Append the search-tree path source -> end to out, excluding the source
+    // itself (callers' routes already end there). Walks parents once and
+    // reverses in place, so the cost is O(path length).
+    void appendPath(int end, vector<int>& out) const {
+        size_t mark = out.size();
+        for (int v = end; parent[v] != -1; v = parent[v])
+            out.push_back(v);
+        reverse(out.begin() + mark, out.end());
+    }
+
+    void push(const SearchState& s) { heap.push(s); }
+
+    SearchState pop() { return heap.pop(); }
+};
+
+using DijkstraWorkspace = BasicDijkstraWorkspace<double>;